@@ -0,0 +1,89 @@
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include <duktape-cpp/DuktapeCpp.h>
+
+/**
+ * Measures calls of bound methods from a script loop.
+ * The same class is bound with default checks and as trusted (see DUK_CPP_DEF_TRUSTED),
+ * checks and method lookups of trusted class are skipped only in release builds (-DCMAKE_BUILD_TYPE=Release).
+ */
+namespace Bench {
+
+template <int Tag>
+class Body {
+public:
+    static std::shared_ptr<Body> create(double x) { return std::make_shared<Body>(x); }
+
+    explicit Body(double x): _x(x) {}
+
+    void step(double dt, int times) { _x += dt * times; }
+    double x() const { return _x; }
+    void attract(Body &other) { _x += (other._x - _x) * 0.5; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.construct(&Body::create);
+        i.method("step", &Body::step);
+        i.method("attract", &Body::attract);
+        i.property("x", &Body::x);
+    }
+
+private:
+    double _x;
+};
+
+typedef Body<0> Checked;
+typedef Body<1> Trusted;
+
+}
+
+DUK_CPP_DEF_CLASS_NAME(Bench::Checked);
+DUK_CPP_DEF_CLASS_NAME(Bench::Trusted);
+DUK_CPP_DEF_TRUSTED(Bench::Trusted);
+
+namespace {
+
+const int Iterations = 1000000;
+
+template <class T>
+void run(const char *label, const char *className) {
+    duk::Context ctx;
+    ctx.registerClass<T>();
+
+    std::string script = std::string() +
+        "var a = new Bench." + className + "(1), b = new Bench." + className + "(2);\n"
+        "for (var i = 0; i < " + std::to_string(Iterations) + "; ++i) {\n"
+        "    a.step(0.5, 2); a.attract(b); b.x;\n"
+        "}\n"
+        "a.x";
+
+    auto start = std::chrono::steady_clock::now();
+    double res = 0;
+    ctx.evalString(res, script.c_str());
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    double ns = double(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    std::printf("%-8s %8.1f ms  %6.1f ns/call  (result %g)\n",
+                label, ns / 1e6, ns / (3.0 * Iterations), res);
+}
+
+}
+
+int main() {
+    try {
+#if !defined(NDEBUG)
+        std::printf("debug build: trusted bindings keep checks\n");
+#endif
+        run<Bench::Checked>("checked", "Checked");
+        run<Bench::Trusted>("trusted", "Trusted");
+    }
+    catch (std::exception &e) {
+        std::printf("error: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
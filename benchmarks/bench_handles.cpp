@@ -0,0 +1,103 @@
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+#include <duktape-cpp/DuktapeCpp.h>
+
+/**
+ * Measures calls of a script function from native code: looking the function up by name
+ * on every call (see `Context::getGlobal`) and calling it through `FunctionHandle`,
+ * one call per element and as a batch (see `FunctionHandle::callEach`).
+ * Method of a script object is called by evaluating script and through `JSObject`.
+ */
+namespace {
+
+const int Iterations = 1000000;
+
+const char Script[] =
+    "var ticks = 0; function onTick(dt) { ticks += dt; }"
+    "function isSelected(id) { return id % 3 == 0; }"
+    "var plugin = { frames: 0, update: function (dt) { this.frames += dt; } };";
+
+void report(const char *label, std::chrono::steady_clock::duration elapsed) {
+    double ns = double(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    std::printf("%-8s %8.1f ms  %6.1f ns/call\n", label, ns / 1e6, ns / Iterations);
+}
+
+template <class F>
+void measure(const char *label, F call) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < Iterations; ++i) {
+        call();
+    }
+    report(label, std::chrono::steady_clock::now() - start);
+}
+
+}
+
+int main() {
+    try {
+        duk::Context ctx;
+        ctx.evalStringNoRes(Script);
+
+        measure("by name", [&ctx] {
+            std::function<void(double)> onTick;
+            ctx.getGlobal("onTick", onTick);
+            onTick(1.0);
+        });
+
+        duk::FunctionHandle<void(double)> onTick(ctx, "onTick");
+        measure("handle", [&onTick] {
+            onTick(1.0);
+        });
+
+        std::vector<int> records(Iterations);
+        for (int i = 0; i < Iterations; ++i) {
+            records[i] = i;
+        }
+        std::vector<char> selected;
+        selected.reserve(records.size());
+
+        duk::FunctionHandle<bool(int)> isSelected(ctx, "isSelected");
+
+        std::function<bool(int)> isSelectedFunc;
+        ctx.getGlobal("isSelected", isSelectedFunc);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int id : records) {
+            selected.push_back(isSelectedFunc(std::move(id)));
+        }
+        report("function", std::chrono::steady_clock::now() - start);
+
+        selected.clear();
+        start = std::chrono::steady_clock::now();
+        for (int id : records) {
+            selected.push_back(isSelected(id));
+        }
+        report("loop", std::chrono::steady_clock::now() - start);
+
+        selected.clear();
+        start = std::chrono::steady_clock::now();
+        isSelected.callEach(records.begin(), records.end(), std::back_inserter(selected));
+        report("batch", std::chrono::steady_clock::now() - start);
+
+        measure("eval", [&ctx] {
+            ctx.evalStringNoRes("plugin.update(1)");
+        });
+
+        duk::JSObject plugin;
+        ctx.getGlobal("plugin", plugin);
+        duk::PropertyKey update(ctx, "update");
+        measure("method", [&plugin, &update] {
+            plugin.call<void>(update, 1.0);
+        });
+    }
+    catch (std::exception &e) {
+        std::printf("error: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
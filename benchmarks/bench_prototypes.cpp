@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <duktape-cpp/DuktapeCpp.h>
+
+/**
+ * Measures registration of a class with 200 methods bound as function objects,
+ * as lightfuncs (see DUK_CPP_DEF_LIGHTFUNCS), registered lazily (see ClassRegistration)
+ * and replayed from the process-wide TypeRegistry. Each mode reports the best of several rounds.
+ */
+namespace Bench {
+
+template <int Tag>
+class Wide {
+public:
+    static std::shared_ptr<Wide> create() { return std::make_shared<Wide>(); }
+
+    template <int N>
+    int nth() const { return N; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.construct(&Wide::create);
+        inspectNth(i, std::make_index_sequence<200>{});
+    }
+
+private:
+    template <class Inspector, std::size_t ... N>
+    static void inspectNth(Inspector &i, std::index_sequence<N...>) {
+        static const std::string names[] = { ("nth" + std::to_string(N))... };
+        (void)std::initializer_list<int> { (i.method(names[N].c_str(), &Wide::nth<int(N)>), 0)... };
+    }
+};
+
+typedef Wide<0> Functions;
+typedef Wide<1> LightFuncs;
+typedef Wide<2> Registered;
+
+}
+
+DUK_CPP_DEF_CLASS_NAME(Bench::Functions);
+DUK_CPP_DEF_CLASS_NAME(Bench::LightFuncs);
+DUK_CPP_DEF_CLASS_NAME(Bench::Registered);
+DUK_CPP_DEF_LIGHTFUNCS(Bench::LightFuncs);
+DUK_CPP_REGISTER_CLASS(Bench::Registered);
+
+namespace {
+
+const int Contexts = 200;
+const int Rounds = 5;
+
+template <class F>
+double best(F measureRound) {
+    double res = measureRound();
+    for (int i = 1; i < Rounds; ++i) {
+        res = std::min(res, measureRound());
+    }
+    return res;
+}
+
+template <class T>
+double measure(duk::ClassRegistration mode = duk::ClassRegistration::Eager) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < Contexts; ++i) {
+        duk::Context ctx;
+        ctx.setClassRegistration(mode);
+        ctx.registerClass<T>();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    return double(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()) / Contexts;
+}
+
+double measureRegistry() {
+    duk::ContextOptions options;
+    options.registeredTypes = true;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < Contexts; ++i) {
+        duk::Context ctx(options);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    return double(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()) / Contexts;
+}
+
+double measureEmpty() {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < Contexts; ++i) {
+        duk::Context ctx;
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    return double(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()) / Contexts;
+}
+
+}
+
+int main() {
+    try {
+        double empty = best(measureEmpty);
+        std::printf("%-10s %8.1f us per context\n", "empty", empty);
+        std::printf("%-10s %8.1f us per registration\n", "functions",
+                    best([] { return measure<Bench::Functions>(); }) - empty);
+        std::printf("%-10s %8.1f us per registration\n", "lightfuncs",
+                    best([] { return measure<Bench::LightFuncs>(); }) - empty);
+        std::printf("%-10s %8.1f us per registration\n", "lazy",
+                    best([] { return measure<Bench::Functions>(duk::ClassRegistration::Lazy); }) - empty);
+        std::printf("%-10s %8.1f us per registration\n", "registry", best(measureRegistry) - empty);
+    }
+    catch (std::exception &e) {
+        std::printf("error: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -2939,6 +2939,29 @@ typedef struct duk_hthread duk_context;
 
 /* __OVERRIDE_DEFINES__ */
 
+/*
+ *  duktape-cpp interrupt hook (enabled by DUK_CPP_ENABLE_INTERRUPT_HOOK
+ *  CMake option).  Heap udata must point to a structure whose first member
+ *  is a duk_cpp_interrupt_hook, see duk::details::HeapData.
+ */
+
+#if defined(DUK_CPP_INTERRUPT_HOOK)
+typedef duk_bool_t (*duk_cpp_interrupt_hook)(void *udata);
+#define DUK_USE_INTERRUPT_COUNTER
+#define DUK_USE_EXEC_TIMEOUT_CHECK(udata) \
+	((udata) != NULL && *((duk_cpp_interrupt_hook *) (udata)) != NULL && \
+	 (*((duk_cpp_interrupt_hook *) (udata)))((udata)))
+#endif
+
+/*
+ *  duktape-cpp fastint support (enabled by DUK_CPP_ENABLE_FASTINT CMake
+ *  option).  Integers are then stored without conversion to double.
+ */
+
+#if defined(DUK_CPP_FASTINT) && defined(DUK_USE_64BIT_OPS)
+#define DUK_USE_FASTINT
+#endif
+
 /*
  *  Date provider selection
  *
@@ -16051,6 +16051,87 @@ DUK_EXTERNAL void duk_gc(duk_context *ctx, duk_uint_t flags) {
 	ms_flags = (duk_small_uint_t) flags;
 	duk_heap_mark_and_sweep(heap, ms_flags);
 }
+
+/*
+ *  duktape-cpp extensions: defer automatic mark-and-sweep and count heap objects.
+ */
+
+DUK_EXTERNAL void duk_cpp_gc_prevent(duk_context *ctx) {
+	duk_hthread *thr = (duk_hthread *) ctx;
+
+	DUK_ASSERT_CTX_VALID(ctx);
+	thr->heap->ms_prevent_count++;
+	DUK_ASSERT(thr->heap->ms_prevent_count != 0);  /* Wrap. */
+}
+
+DUK_EXTERNAL void duk_cpp_gc_allow(duk_context *ctx) {
+	duk_hthread *thr = (duk_hthread *) ctx;
+
+	DUK_ASSERT_CTX_VALID(ctx);
+	DUK_ASSERT(thr->heap->ms_prevent_count > 0);
+	thr->heap->ms_prevent_count--;
+}
+
+DUK_EXTERNAL duk_size_t duk_cpp_heap_object_count(duk_context *ctx) {
+	duk_hthread *thr = (duk_hthread *) ctx;
+	duk_heap *heap;
+	duk_heaphdr *curr;
+	duk_size_t count = 0;
+
+	DUK_ASSERT_CTX_VALID(ctx);
+	heap = thr->heap;
+
+	for (curr = heap->heap_allocated; curr != NULL; curr = DUK_HEAPHDR_GET_NEXT(heap, curr)) {
+		count++;
+	}
+#if defined(DUK_USE_FINALIZER_SUPPORT)
+	for (curr = heap->finalize_list; curr != NULL; curr = DUK_HEAPHDR_GET_NEXT(heap, curr)) {
+		count++;
+	}
+#endif
+	return count;
+}
+
+#if defined(DUK_USE_64BIT_OPS)
+/*
+ *  duktape-cpp extension: get number as a 64-bit integer.  Fastints are
+ *  read without conversion to double.  Returns 1 if the value is a number
+ *  with an integer value in int64 range, otherwise returns 0 and leaves
+ *  *out_val untouched.
+ */
+
+DUK_EXTERNAL duk_bool_t duk_cpp_get_int64(duk_context *ctx, duk_idx_t idx, duk_int64_t *out_val) {
+	duk_tval *tv;
+	duk_double_t d;
+
+	DUK_ASSERT_CTX_VALID(ctx);
+	DUK_ASSERT(out_val != NULL);
+
+	tv = duk_get_tval_or_unused(ctx, idx);
+	DUK_ASSERT(tv != NULL);
+
+#if defined(DUK_USE_FASTINT)
+	if (DUK_TVAL_IS_FASTINT(tv)) {
+		*out_val = (duk_int64_t) DUK_TVAL_GET_FASTINT(tv);
+		return 1;
+	}
+#endif
+
+	if (!DUK_TVAL_IS_NUMBER(tv)) {
+		return 0;
+	}
+
+	d = DUK_TVAL_GET_NUMBER(tv);
+
+	/* -2^63 is representable, 2^63 is not; NaN fails the comparison. */
+	if (!(d >= -9223372036854775808.0 && d < 9223372036854775808.0) || DUK_FLOOR(d) != d) {
+		return 0;
+	}
+
+	*out_val = (duk_int64_t) d;
+	return 1;
+}
+#endif  /* DUK_USE_64BIT_OPS */
 #line 1 "duk_api_object.c"
 /*
  *  Object handling: property access and other support functions.
@@ -51721,6 +51802,88 @@ DUK_INTERNAL duk_uint_fast32_t duk_hobject_pc2line_query(duk_context *ctx, duk_i
 }
 
 #endif  /* DUK_USE_PC2LINE */
+
+/*
+ *  duktape-cpp extension: sample call stack of the running thread without
+ *  touching the value stack or allocating, so that it can be called from the
+ *  executor interrupt.  Frames of the running thread (heap->curr_thread) are
+ *  written from the innermost one, followed by frames of the threads which
+ *  resumed it.  Returns number of frames written, frames beyond max_frames
+ *  (closest to the root) are dropped.  Strings point to heap strings and are
+ *  valid until the next allocation in the heap.
+ */
+
+DUK_LOCAL duk_hstring *duk__cpp_own_string_prop(duk_heap *heap, duk_hobject *obj, duk_hstring *key) {
+	duk_tval *tv;
+
+	tv = duk_hobject_find_existing_entry_tval_ptr(heap, obj, key);
+	if (tv != NULL && DUK_TVAL_IS_STRING(tv)) {
+		return DUK_TVAL_GET_STRING(tv);
+	}
+	return NULL;
+}
+
+DUK_EXTERNAL duk_int_t duk_cpp_sample_callstack(duk_context *ctx, duk_cpp_frame *frames, duk_int_t max_frames) {
+	duk_hthread *thr = (duk_hthread *) ctx;
+	duk_heap *heap;
+	duk_hthread *curr;
+	duk_int_t count = 0;
+
+	DUK_ASSERT_CTX_VALID(ctx);
+	DUK_ASSERT(frames != NULL || max_frames <= 0);
+	heap = thr->heap;
+
+	for (curr = heap->curr_thread; curr != NULL; curr = curr->resumer) {
+		duk_size_t i;
+
+		for (i = curr->callstack_top; i > 0 && count < max_frames; i--) {
+			duk_activation *act = curr->callstack + i - 1;
+			duk_cpp_frame *frame = frames + count;
+			duk_hstring *h;
+
+			DUK_MEMZERO(frame, sizeof(*frame));
+			count++;
+
+			if (act->func == NULL) {
+				/* lightfunc */
+				frame->is_native = 1;
+				continue;
+			}
+
+			h = duk__cpp_own_string_prop(heap, act->func, DUK_HEAP_STRING_NAME(heap));
+			if (h != NULL) {
+				frame->name = (const char *) DUK_HSTRING_GET_DATA(h);
+				frame->name_len = (duk_size_t) DUK_HSTRING_GET_BYTELEN(h);
+			}
+
+			if (!DUK_HOBJECT_IS_COMPFUNC(act->func)) {
+				frame->is_native = 1;
+				continue;
+			}
+
+			h = duk__cpp_own_string_prop(heap, act->func, DUK_HEAP_STRING_FILE_NAME(heap));
+			if (h != NULL) {
+				frame->file_name = (const char *) DUK_HSTRING_GET_DATA(h);
+				frame->file_name_len = (duk_size_t) DUK_HSTRING_GET_BYTELEN(h);
+			}
+
+#if defined(DUK_USE_PC2LINE)
+			{
+				duk_tval *tv;
+
+				tv = duk_hobject_find_existing_entry_tval_ptr(heap, act->func, DUK_HEAP_STRING_INT_PC2LINE(heap));
+				if (tv != NULL && DUK_TVAL_IS_BUFFER(tv)) {
+					frame->line = (duk_uint_t) duk__hobject_pc2line_query_raw(curr,
+					                                                          (duk_hbuffer_fixed *) DUK_TVAL_GET_BUFFER(tv),
+					                                                          duk_hthread_get_act_prev_pc(curr, act));
+				}
+			}
+#endif
+		}
+	}
+
+	return count;
+}
 #line 1 "duk_hobject_props.c"
 /*
  *  duk_hobject property access functionality.
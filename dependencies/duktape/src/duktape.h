@@ -442,6 +442,25 @@ DUK_EXTERNAL_DECL void *duk_realloc(duk_context *ctx, void *ptr, duk_size_t size
 DUK_EXTERNAL_DECL void duk_get_memory_functions(duk_context *ctx, duk_memory_functions *out_funcs);
 DUK_EXTERNAL_DECL void duk_gc(duk_context *ctx, duk_uint_t flags);
 
+/* duktape-cpp extensions, see duktape.c */
+DUK_EXTERNAL_DECL void duk_cpp_gc_prevent(duk_context *ctx);
+DUK_EXTERNAL_DECL void duk_cpp_gc_allow(duk_context *ctx);
+DUK_EXTERNAL_DECL duk_size_t duk_cpp_heap_object_count(duk_context *ctx);
+#if defined(DUK_USE_64BIT_OPS)
+DUK_EXTERNAL_DECL duk_bool_t duk_cpp_get_int64(duk_context *ctx, duk_idx_t idx, duk_int64_t *out_val);
+#endif
+
+typedef struct {
+	const char *name;       /* own 'name' of the function, NULL if none */
+	duk_size_t name_len;
+	const char *file_name;  /* own 'fileName' of the function, NULL if none */
+	duk_size_t file_name_len;
+	duk_uint_t line;        /* 0 for native functions */
+	duk_bool_t is_native;
+} duk_cpp_frame;
+
+DUK_EXTERNAL_DECL duk_int_t duk_cpp_sample_callstack(duk_context *ctx, duk_cpp_frame *frames, duk_int_t max_frames);
+
 /*
  *  Error handling
  */
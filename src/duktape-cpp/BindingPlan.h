@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <vector>
+
+#include <duktape.h>
+
+#include "NativeObject.h"
+
+namespace duk {
+
+class Context;
+
+namespace details {
+
+struct BindingStatsRecord;
+
+/**
+ * Recorded native function: trampoline `func` reads the bound member from a process-wide table
+ * (see `MagicTable`) by `magic`, so replaying it creates a single function object
+ * without hidden properties, finalizer and allocations.
+ * If `pushIndexed` is set, it pushes entry `magic` of another table instead
+ * (lightfunc of `LightFuncTable` or constant).
+ */
+struct PlanFunction {
+    duk_c_function func = nullptr;
+    duk_idx_t nargs = 0;
+    duk_int_t magic = 0;
+    void (*pushIndexed)(duk::Context &d, std::size_t index) = nullptr;
+    BindingStatsRecord *stats = nullptr;    ///< see `AttachBindingStats`
+    const char *traceName = nullptr;        ///< see `AttachTraceName`
+
+    bool isSet() const { return func || pushIndexed; }
+};
+
+/**
+ * Recorded property definition of property `name`, defined with `flags` (see duk_def_prop).
+ * Value (or getter and setter) is pushed by `push` for bindings which can't be kept in tables
+ * (overloads, async methods), otherwise by replaying `value` and `setter`.
+ */
+struct PlanStep {
+    std::string name;
+    duk_uint_t flags;
+    PlanFunction value;     ///< value or getter
+    PlanFunction setter;
+    std::function<void(duk::Context &d)> push;
+};
+
+/**
+ * Binding plan of a class, recorded once per process by inspecting the class (see `TypeRegistry`)
+ */
+struct ClassPlan {
+    explicit ClassPlan(std::type_index type): type(type) {}
+
+    std::type_index type;
+    const NativeType *nativeType = nullptr;
+
+    std::vector<std::string> path;      ///< namespaces and class name
+    std::vector<PlanStep> statics;      ///< constants and static methods, defined on constructor
+    std::vector<PlanStep> prototype;    ///< members declared by the class
+
+    PlanFunction constructor;                               ///< not set if class has no constructor or has overloads
+    std::function<void(duk::Context &d)> pushConstructor;  ///< constructor overloads, empty otherwise
+
+    bool hasConstructor() const { return constructor.isSet() || pushConstructor; }
+
+    void (*pushPrototype)(duk::Context &d) = nullptr;   ///< see `PushPrototype`
+
+    // lazy registration (see `ClassRegistration::Lazy`)
+    duk_c_function lazyGet = nullptr;
+    duk_c_function lazySet = nullptr;
+    void (*registerPrototype)(duk::Context &d) = nullptr;
+};
+
+/**
+ * Plan of class T if it is registered in `TypeRegistry`
+ */
+template <class T>
+struct ClassPlanOf {
+    static std::atomic<const ClassPlan*> & slot() {
+        static std::atomic<const ClassPlan*> plan { nullptr };
+        return plan;
+    }
+
+    static const ClassPlan * get() { return slot().load(std::memory_order_acquire); }
+};
+
+/**
+ * Process-wide list of class plans in registration order, plans are never removed
+ */
+class ClassPlans {
+public:
+    static ClassPlans & Instance() {
+        static ClassPlans instance;
+        return instance;
+    }
+
+    void add(std::unique_ptr<ClassPlan> plan) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _plans.push_back(std::move(plan));
+    }
+
+    std::vector<const ClassPlan*> snapshot() {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        std::vector<const ClassPlan*> res;
+        res.reserve(_plans.size());
+        for (auto const &p : _plans) {
+            res.push_back(p.get());
+        }
+        return res;
+    }
+
+private:
+    std::mutex _mutex;
+    std::vector<std::unique_ptr<ClassPlan>> _plans;
+};
+
+}}
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <duktape.h>
+
+#include "HeapData.h"
+
+namespace duk {
+
+/**
+ * @brief Call statistics of native bindings (methods, constructors and property accessors)
+ * @details Stats are collected only if library is built with DUK_CPP_ENABLE_BINDING_STATS
+ *          CMake option, otherwise instrumentation compiles to nothing and `Snapshot` is always empty.
+ *          Bindings are keyed by class name (see `ClassName`) and member name,
+ *          accessors are named `get <name>` / `set <name>`, constructors `constructor`.
+ *          Stats are process-wide and shared by all contexts.
+ *          Calls aborted by script error are recorded too.
+ */
+struct BindingStats {
+    /**
+     * Number of histogram buckets, bucket `i` counts calls which took [2^i, 2^(i+1)) nanoseconds,
+     * the last bucket also counts all longer calls
+     */
+    static constexpr std::size_t NumBuckets = 32;
+
+    std::string className;
+    std::string member;
+    std::uint64_t calls { 0 };
+    std::chrono::nanoseconds totalTime { 0 };
+    std::array<std::uint64_t, NumBuckets> histogram {};
+
+    static constexpr bool IsEnabled() {
+#if defined(DUK_CPP_BINDING_STATS)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Get stats of all bindings which were called at least once, sorted by class and member name
+     */
+    static std::vector<BindingStats> Snapshot();
+
+    /**
+     * @brief Reset stats of all bindings
+     */
+    static void Reset();
+
+    /**
+     * @brief Get histogram bucket of call duration
+     */
+    static std::size_t BucketOf(std::chrono::nanoseconds duration) {
+        auto ns = static_cast<std::uint64_t>(duration.count() > 0 ? duration.count() : 0);
+        std::size_t bucket = 0;
+        while (ns > 1 && bucket + 1 < NumBuckets) {
+            ns >>= 1;
+            bucket += 1;
+        }
+        return bucket;
+    }
+};
+
+namespace details {
+
+#if defined(DUK_CPP_BINDING_STATS)
+
+/**
+ * Counters of a single binding, updated from any thread running a context
+ */
+struct BindingStatsRecord {
+    std::string className;
+    std::string member;
+    std::atomic<std::uint64_t> calls { 0 };
+    std::atomic<std::uint64_t> totalNs { 0 };
+    std::array<std::atomic<std::uint64_t>, BindingStats::NumBuckets> histogram {};
+
+    BindingStatsRecord(std::string className, std::string member)
+        : className(std::move(className)), member(std::move(member)) {}
+
+    void record(std::chrono::nanoseconds duration) {
+        calls.fetch_add(1, std::memory_order_relaxed);
+        totalNs.fetch_add(static_cast<std::uint64_t>(duration.count()), std::memory_order_relaxed);
+        histogram[BindingStats::BucketOf(duration)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void reset() {
+        calls.store(0, std::memory_order_relaxed);
+        totalNs.store(0, std::memory_order_relaxed);
+        for (auto &b : histogram) {
+            b.store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+/**
+ * Process-wide registry of binding records, records are never removed so pointers stay valid
+ */
+class BindingStatsRegistry {
+public:
+    static BindingStatsRegistry & Instance() {
+        static BindingStatsRegistry instance;
+        return instance;
+    }
+
+    BindingStatsRecord * find(const char *className, const char *member) {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        auto key = std::make_pair(std::string(className), std::string(member));
+        auto it = _index.find(key);
+        if (it != _index.end()) {
+            return it->second;
+        }
+
+        _records.emplace_back(key.first, key.second);
+        BindingStatsRecord *rec = &_records.back();
+        _index.emplace(std::move(key), rec);
+        return rec;
+    }
+
+    std::vector<BindingStats> snapshot() {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        std::vector<BindingStats> res;
+        for (auto const &kv : _index) {
+            BindingStatsRecord const &rec = *kv.second;
+
+            BindingStats stats;
+            stats.calls = rec.calls.load(std::memory_order_relaxed);
+            if (stats.calls == 0) {
+                continue;
+            }
+
+            stats.className = rec.className;
+            stats.member = rec.member;
+            stats.totalTime = std::chrono::nanoseconds(rec.totalNs.load(std::memory_order_relaxed));
+            for (std::size_t i = 0; i < BindingStats::NumBuckets; ++i) {
+                stats.histogram[i] = rec.histogram[i].load(std::memory_order_relaxed);
+            }
+            res.push_back(std::move(stats));
+        }
+
+        return res;
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (auto &rec : _records) {
+            rec.reset();
+        }
+    }
+
+private:
+    std::mutex _mutex;
+    std::deque<BindingStatsRecord> _records;
+    std::map<std::pair<std::string, std::string>, BindingStatsRecord*> _index;
+};
+
+/**
+ * Attach stats record to the native function at `funcIndex`
+ */
+inline void AttachBindingStatsRecord(duk_context *d, int funcIndex, BindingStatsRecord *rec) {
+    int fidx = duk_normalize_index(d, funcIndex);
+    duk_push_pointer(d, rec);
+    details::PutHiddenProp(d, fidx, details::HiddenKey::StatsPtr);
+}
+
+inline void AttachBindingStats(duk_context *d, int funcIndex, const char *className, const char *member) {
+    AttachBindingStatsRecord(d, funcIndex, BindingStatsRegistry::Instance().find(className, member));
+}
+
+inline void AttachBindingStats(duk_context *d, int funcIndex, const char *className, const char *prefix, const char *member) {
+    AttachBindingStats(d, funcIndex, className, (std::string(prefix) + member).c_str());
+}
+
+/**
+ * Get stats record of the binding, for functions which can't hold it (see `LightFuncTable`)
+ */
+inline BindingStatsRecord * FindBindingStats(const char *className, const char *prefix, const char *member) {
+    return BindingStatsRegistry::Instance().find(className, (std::string(prefix) + member).c_str());
+}
+
+/**
+ * Get stats record of the currently running native function (see `AttachBindingStats`)
+ */
+inline BindingStatsRecord * CurrentBindingStats(duk_context *d) {
+    duk_push_current_function(d);
+    details::GetHiddenProp(d, -1, details::HiddenKey::StatsPtr);
+    auto *rec = reinterpret_cast<BindingStatsRecord*>(duk_get_pointer(d, -1));
+    duk_pop_2(d);
+    return rec;
+}
+
+#else
+
+struct BindingStatsRecord;
+
+inline void AttachBindingStatsRecord(duk_context *, int, BindingStatsRecord *) {}
+inline void AttachBindingStats(duk_context *, int, const char *, const char *) {}
+inline void AttachBindingStats(duk_context *, int, const char *, const char *, const char *) {}
+
+inline BindingStatsRecord * FindBindingStats(const char *, const char *, const char *) { return nullptr; }
+
+inline BindingStatsRecord * CurrentBindingStats(duk_context *) { return nullptr; }
+
+#endif
+
+}
+
+inline std::vector<BindingStats> BindingStats::Snapshot() {
+#if defined(DUK_CPP_BINDING_STATS)
+    return details::BindingStatsRegistry::Instance().snapshot();
+#else
+    return {};
+#endif
+}
+
+inline void BindingStats::Reset() {
+#if defined(DUK_CPP_BINDING_STATS)
+    details::BindingStatsRegistry::Instance().reset();
+#endif
+}
+
+}
@@ -29,6 +29,24 @@ struct Constructor {
      * @param d duktape context
      */
     static duk_ret_t func(duk_context *d);
+
+    /**
+     * Same as `func` for constructors kept in `MagicTable`, index of the constructor is the magic
+     * @param d duktape context
+     */
+    static duk_ret_t tableFunc(duk_context *d);
+
+    /**
+     * Constructor calls made by `func` and `tableFunc` (see `InstrumentedCall`)
+     * @param d duktape context
+     */
+    static duk_ret_t call(duk_context *d);
+    static duk_ret_t tableCall(duk_context *d);
+
+    /**
+     * Call `constructor` with arguments from the stack and push the result
+     */
+    static duk_ret_t construct(duk_context *d, TFunc constructor);
 };
 
 /**
@@ -52,6 +70,24 @@ struct ConstructorUnique {
      * @param d duktape context
      */
     static duk_ret_t func(duk_context *d);
+
+    /**
+     * Same as `func` for constructors kept in `MagicTable`, index of the constructor is the magic
+     * @param d duktape context
+     */
+    static duk_ret_t tableFunc(duk_context *d);
+
+    /**
+     * Constructor calls made by `func` and `tableFunc` (see `InstrumentedCall`)
+     * @param d duktape context
+     */
+    static duk_ret_t call(duk_context *d);
+    static duk_ret_t tableCall(duk_context *d);
+
+    /**
+     * Call `constructor` with arguments from the stack and push the result
+     */
+    static duk_ret_t construct(duk_context *d, TFunc constructor);
 };
 
 } // details
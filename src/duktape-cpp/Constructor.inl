@@ -1,12 +1,18 @@
 #pragma once
 
 #include <cassert>
+#include <type_traits>
 
 #include "Constructor.h"
 #include "Context.h"
+#include "BindingStats.h"
+#include "Instrumentation.h"
+#include "MagicTable.h"
+#include "Tracer.h"
 
 #include "./Type.h"
 #include "./Utils/Helpers.h"
+#include "./Utils/ClassInfo.h"
 
 #include "PushObjectInspector.h"
 
@@ -27,10 +33,13 @@ struct ConstructorDispatcher {
         return constructor(getArg<A, I + StackIdx>(d)...);
     }
 
+    template <class AA>
+    using ArgType = typename std::conditional<UncheckedCalls<C>::value, UncheckedType<ClearType<AA>>, Type<ClearType<AA>>>::type;
+
     template <class AA, int Index>
     static ClearType<AA> getArg(duk::Context &d) {
         ClearType<AA> instance;
-        Type<ClearType<AA>>::get(d, instance, Index);
+        ArgType<AA>::get(d, instance, Index);
         return instance;
     }
 };
@@ -41,29 +50,48 @@ inline void Constructor<C, A...>::push(duk::Context &d, std::shared_ptr<C> (*con
 
     duk_push_c_function(d, func, sizeof...(A));
     duk_push_pointer(d, (void*)constructor);
-    duk_put_prop_string(d, -2, "\xff" "func_ptr");
+    details::PutHiddenProp(d, -2, details::HiddenKey::FuncPtr);
+
+    AttachBindingStats(d, -1, ClassName<C>::value, "constructor");
 }
 
 template <class C, class ... A>
 inline duk_ret_t Constructor<C, A...>::func(duk_context *d) {
-   if (!duk_is_constructor_call(d)) {
-      duk_error(d, DUK_RET_TYPE_ERROR, "Constructor must be called with 'new'.");
-      return DUK_RET_TYPE_ERROR;
-   }
-    
-   duk_push_global_stash(d);
-   duk_get_prop_string(d, -1, "self_ptr");
-   duk::Context *ctx = reinterpret_cast<duk::Context*>(duk_get_pointer(d, -1));
-   duk_pop_2(d);
+   return InstrumentedCall(d, call, CurrentBindingStats(d), ClassName<C>::value, "constructor");
+}
 
-   assert(ctx);
+template <class C, class ... A>
+inline duk_ret_t Constructor<C, A...>::tableFunc(duk_context *d) {
+   return InstrumentedCall(d, tableCall, CurrentBindingStats(d), ClassName<C>::value, "constructor");
+}
 
+template <class C, class ... A>
+inline duk_ret_t Constructor<C, A...>::call(duk_context *d) {
    duk_push_current_function(d);
-   duk_get_prop_string(d, -1, "\xff" "func_ptr");
+   details::GetHiddenProp(d, -1, details::HiddenKey::FuncPtr);
    TFunc f = reinterpret_cast<TFunc>(duk_get_pointer(d, -1));
    duk_pop_2(d);
 
+   return construct(d, f);
+}
+
+template <class C, class ... A>
+inline duk_ret_t Constructor<C, A...>::tableCall(duk_context *d) {
+   return construct(d, MagicTable<TFunc>::get(duk_get_current_magic(d)));
+}
+
+template <class C, class ... A>
+inline duk_ret_t Constructor<C, A...>::construct(duk_context *d, TFunc f) {
+   if (!UncheckedCalls<C>::value && !duk_is_constructor_call(d)) {
+      duk_error(d, DUK_RET_TYPE_ERROR, "Constructor must be called with 'new'.");
+      return DUK_RET_TYPE_ERROR;
+   }
+
+   duk::Context *ctx = &Context::GetSelfFromContext(d);
+
+   assert(ctx);
    assert(f);
+   Context::ThreadScope scope(*ctx, d);
 
    ConstructorDispatcher<0, C, A...> dispatcher;
    return dispatcher.dispatch(f, *ctx);
@@ -85,10 +113,13 @@ struct ConstructorDispatcherUnique {
         return constructor(getArg<A, I + StackIdx>(d)...);
     }
 
+    template <class AA>
+    using ArgType = typename std::conditional<UncheckedCalls<C>::value, UncheckedType<ClearType<AA>>, Type<ClearType<AA>>>::type;
+
     template <class AA, int Index>
     static ClearType<AA> getArg(duk::Context &d) {
         ClearType<AA> instance;
-        Type<ClearType<AA>>::get(d, instance, Index);
+        ArgType<AA>::get(d, instance, Index);
         return instance;
     }
 };
@@ -99,29 +130,48 @@ inline void ConstructorUnique<C, A...>::push(duk::Context &d, std::unique_ptr<C>
 
     duk_push_c_function(d, func, sizeof...(A));
     duk_push_pointer(d, (void*)constructor);
-    duk_put_prop_string(d, -2, "\xff" "func_ptr");
+    details::PutHiddenProp(d, -2, details::HiddenKey::FuncPtr);
+
+    AttachBindingStats(d, -1, ClassName<C>::value, "constructor");
 }
 
 template <class C, class ... A>
 inline duk_ret_t ConstructorUnique<C, A...>::func(duk_context *d) {
-   if (!duk_is_constructor_call(d)) {
-      duk_error(d, DUK_RET_TYPE_ERROR, "Constructor must be called with 'new'.");
-      return DUK_RET_TYPE_ERROR;
-   }
-    
-   duk_push_global_stash(d);
-   duk_get_prop_string(d, -1, "self_ptr");
-   duk::Context *ctx = reinterpret_cast<duk::Context*>(duk_get_pointer(d, -1));
-   duk_pop_2(d);
+   return InstrumentedCall(d, call, CurrentBindingStats(d), ClassName<C>::value, "constructor");
+}
 
-   assert(ctx);
+template <class C, class ... A>
+inline duk_ret_t ConstructorUnique<C, A...>::tableFunc(duk_context *d) {
+   return InstrumentedCall(d, tableCall, CurrentBindingStats(d), ClassName<C>::value, "constructor");
+}
 
+template <class C, class ... A>
+inline duk_ret_t ConstructorUnique<C, A...>::call(duk_context *d) {
    duk_push_current_function(d);
-   duk_get_prop_string(d, -1, "\xff" "func_ptr");
+   details::GetHiddenProp(d, -1, details::HiddenKey::FuncPtr);
    TFunc f = reinterpret_cast<TFunc>(duk_get_pointer(d, -1));
    duk_pop_2(d);
 
+   return construct(d, f);
+}
+
+template <class C, class ... A>
+inline duk_ret_t ConstructorUnique<C, A...>::tableCall(duk_context *d) {
+   return construct(d, MagicTable<TFunc>::get(duk_get_current_magic(d)));
+}
+
+template <class C, class ... A>
+inline duk_ret_t ConstructorUnique<C, A...>::construct(duk_context *d, TFunc f) {
+   if (!UncheckedCalls<C>::value && !duk_is_constructor_call(d)) {
+      duk_error(d, DUK_RET_TYPE_ERROR, "Constructor must be called with 'new'.");
+      return DUK_RET_TYPE_ERROR;
+   }
+
+   duk::Context *ctx = &Context::GetSelfFromContext(d);
+
+   assert(ctx);
    assert(f);
+   Context::ThreadScope scope(*ctx, d);
 
    ConstructorDispatcherUnique<0, C, A...> dispatcher;
    return dispatcher.dispatch(f, *ctx);
@@ -1,17 +1,72 @@
 #pragma once
 
+#include <chrono>
 #include <map>
 #include <string>
 #include <atomic>
 #include <memory>
+#include <typeindex>
+#include <unordered_map>
 #include <vector>
 
 #include <duktape.h>
 
 #include "Box.h"
+#include "HeapData.h"
+#include "NativeObject.h"
 
 namespace duk {
 
+/**
+ * @brief Garbage collection mode
+ */
+enum class GcMode {
+    Full,       ///< mark-and-sweep of the whole heap
+    Compact     ///< mark-and-sweep followed by compaction of objects, strings and buffers
+};
+
+/**
+ * @brief Statistics of garbage collection (see `Context::collectGarbage`)
+ */
+struct GcStats {
+    std::chrono::nanoseconds duration { 0 };
+    std::size_t objectsFreed = 0;   ///< objects and buffers freed (strings are not counted)
+    std::size_t finalizersRun = 0;  ///< finalizers of native wrappers and methods
+    std::size_t boxesReleased = 0;  ///< boxes removed from context
+};
+
+/**
+ * @brief How `Context::registerClass` defines classes
+ */
+enum class ClassRegistration {
+    Eager,  ///< constructor and prototype are built when class is registered
+    Lazy    ///< namespace gets accessor property, constructor and prototype are built on first access
+};
+
+/**
+ * @brief Options of a new context
+ */
+struct ContextOptions {
+    /**
+     * Register all classes of the process-wide `TypeRegistry` (from their precomputed binding plans)
+     */
+    bool registeredTypes = false;
+
+    /**
+     * How classes are defined (see `Context::setClassRegistration`), applies to registered types too
+     */
+    ClassRegistration classRegistration = ClassRegistration::Eager;
+};
+
+namespace details {
+
+template <class T>
+struct LazyClass;
+
+struct ClassPlan;
+
+}
+
 /**
  * @brief Wrapper around duktape context
  */
@@ -24,6 +79,14 @@ public:
      * @param scriptId script asset id
      */
     explicit Context(std::string const &scriptId = "");
+
+    /**
+     * @brief constructor from options
+     * @param options context options
+     * @param scriptId script asset id
+     */
+    explicit Context(ContextOptions const &options, std::string const &scriptId = "");
+
     ~Context();
 
     Context(const Context &) = delete;
@@ -42,7 +105,46 @@ public:
      */
     const std::string &scriptId() const { return _scriptId; }
 
-    operator duk_context*() const { return _ctx; }
+    /**
+     * @brief Get pointer to duk_context of the currently running thread
+     * @details Differs from `ptr()` while native code is called from a coroutine (see Coroutine)
+     */
+    duk_context * current() const { return _current; }
+
+    operator duk_context*() const { return _current; }
+
+    /**
+     * @brief Makes `d` the current thread of the context until the scope ends
+     * @details Entry points for calls from javascript use it, so that bindings
+     *          work on the stack of the thread which made the call.
+     */
+    class ThreadScope {
+    public:
+        ThreadScope(Context &ctx, duk_context *d) : _ctx(ctx), _prev(ctx._current) {
+            _ctx._current = d;
+        }
+
+        ~ThreadScope() {
+            restore();
+        }
+
+        /**
+         * @brief Make the previous thread current again
+         * @details Must be called right after every protected call (`duk_pcall`, `duk_peval`, ...)
+         *          made inside the scope. Duktape errors longjmp past destructors of the scopes
+         *          opened by bindings, which leaves their thread current.
+         */
+        void restore() {
+            _ctx._current = _prev;
+        }
+
+        ThreadScope(const ThreadScope &) = delete;
+        ThreadScope & operator = (const ThreadScope &) = delete;
+
+    private:
+        Context &_ctx;
+        duk_context *_prev;
+    };
 
     /**
      * @brief   Store a Box in the context
@@ -76,11 +178,41 @@ public:
 
     /**
      * @brief Register a class to this context (class must have `inspect` method)
+     * @details Class is defined according to `classRegistration`
      * @tparam T class type
      */
     template <class T>
     void registerClass();
 
+    /**
+     * @brief Set how subsequent `registerClass` calls define classes
+     */
+    void setClassRegistration(ClassRegistration mode) { _classRegistration = mode; }
+
+    ClassRegistration classRegistration() const { return _classRegistration; }
+
+    /**
+     * @brief Get prototype and native type descriptor of a class registered with `registerClass`
+     * @details Used to wrap pointers to polymorphic classes with the prototype of their
+     *          dynamic type (see `DUK_CPP_DEF_POLYMORPHIC`). Prototype of lazily registered
+     *          class is built by the first lookup.
+     * @param type class type
+     * @returns registered class or nullptr if class is not registered
+     */
+    details::RegisteredClass const * registeredClass(std::type_index type);
+
+    /**
+     * @brief Get the most-derived registered class of a polymorphic object whose exact type is not registered
+     * @details Registered classes derived from `staticType` (along `BaseClass` declarations) are checked
+     *          with `dynamic_cast`, result is cached per dynamic type.
+     * @param dynamicType dynamic type of the object
+     * @param obj pointer to the object of class `staticType`
+     * @param staticType native type descriptor of the pointer
+     * @returns registered class or nullptr if object is not an instance of any registered class
+     */
+    details::RegisteredClass const * registeredAncestor(std::type_index dynamicType, void *obj,
+                                                        const details::NativeType *staticType);
+
     /**
      * @brief Evaluate string and get result
      * @tparam T result type
@@ -120,6 +252,112 @@ public:
      */
     void getRef(int key);
 
+    /**
+     * Push helper function, compiled from javascript source on first use and kept in the global stash
+     * @param key global stash key
+     * @param src function expression
+     */
+    void pushStashedFunction(details::HiddenKey key, const char *src);
+
+    /**
+     * @brief Check if context is built with interrupt hook (DUK_CPP_ENABLE_INTERRUPT_HOOK CMake option)
+     */
+    static constexpr bool HasInterruptHook() {
+#if defined(DUK_CPP_INTERRUPT_HOOK)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Set handler periodically called from bytecode executor
+     * @details Handler is called about every 256k executed instructions,
+     *          returning true from handler aborts script execution with RangeError.
+     *          Has no effect unless built with interrupt hook (see `HasInterruptHook`).
+     * @param handler handler function or nullptr to remove handler
+     * @param data pointer passed to handler
+     */
+    void setInterruptHandler(bool (*handler)(void *data), void *data);
+
+    /**
+     * @brief Run garbage collection
+     * @details Runs two mark-and-sweep passes, so that objects rescued for finalization are freed
+     *          in the same call. Works while automatic collection is deferred (see `deferGc`),
+     *          so it can be called at a chosen idle point (e.g. end of frame).
+     * @param mode collection mode
+     * @returns collection statistics
+     */
+    GcStats collectGarbage(GcMode mode = GcMode::Full);
+
+    /**
+     * @brief Defer automatic garbage collection until matching `resumeGc` call
+     * @details Calls can be nested. Memory allocated while collection is deferred is freed only
+     *          by reference counting, so keep deferred sections short (see `GcDeferScope`).
+     */
+    void deferGc();
+
+    /**
+     * @brief Allow automatic garbage collection deferred by `deferGc`
+     */
+    void resumeGc();
+
+    bool isGcDeferred() const { return _heapData->gcDeferCount > 0; }
+
+    /**
+     * @brief Defers automatic garbage collection until the scope ends
+     */
+    class GcDeferScope {
+    public:
+        explicit GcDeferScope(Context &ctx) : _ctx(ctx) { _ctx.deferGc(); }
+        ~GcDeferScope() { _ctx.resumeGc(); }
+
+        GcDeferScope(const GcDeferScope &) = delete;
+        GcDeferScope & operator = (const GcDeferScope &) = delete;
+
+    private:
+        Context &_ctx;
+    };
+
+    /**
+     * @brief Scope of objects borrowed by scripts (see `Borrowed`)
+     * @details Wrappers of borrowed objects pushed while the scope is active are invalidated
+     *          in bulk when it ends. Scopes can be nested, objects are tracked by the innermost one,
+     *          references returned by their methods by the scope of the object.
+     *          Context must not be moved while a scope is active.
+     */
+    class BorrowScope {
+    public:
+        explicit BorrowScope(Context &ctx);
+        ~BorrowScope();
+
+        BorrowScope(const BorrowScope &) = delete;
+        BorrowScope & operator = (const BorrowScope &) = delete;
+
+        /**
+         * @brief Track wrapper to invalidate it when the scope ends
+         * @param index index of the wrapper in the current stack
+         */
+        void track(int index);
+
+    private:
+        Context &_ctx;
+        BorrowScope *_prev;
+        int _refKey = -1;
+        duk_uarridx_t _count = 0;
+    };
+
+    /**
+     * @brief Get the innermost active borrow scope or nullptr
+     */
+    BorrowScope * borrowScope() const { return _borrowScope; }
+
+    /**
+     * @brief Count finalizer run for garbage collection statistics
+     * @details Called from finalizers of native wrappers
+     */
+    static void CountFinalizer(duk_context *d);
+
     /**
      * Get global variable
      * @tparam T global variable type
@@ -130,18 +368,49 @@ public:
     void getGlobal(const char *name, T &res);
 
 private:
+    std::unique_ptr<details::HeapData> _heapData;
     duk_context *_ctx;
+    duk_context *_current;
     std::string _scriptId;
     std::atomic_int _boxCounter { 0 };
     std::map<int, std::unique_ptr<BoxBase>> _boxes;
     int _objectRefCounter { 0 };
+    BorrowScope *_borrowScope = nullptr;
+    struct LazyClassEntry {
+        void (*registerPrototype)(Context &ctx);
+        const details::NativeType *type;
+    };
+
+    std::unordered_map<std::type_index, details::RegisteredClass> _classes;
+    std::unordered_map<std::type_index, LazyClassEntry> _lazyClasses;
+    std::unordered_map<std::type_index, std::unordered_map<const details::NativeType*, details::RegisteredClass const*>> _ancestorClasses;
+    ClassRegistration _classRegistration = ClassRegistration::Eager;
+
+    template <class T>
+    friend struct details::LazyClass;
 
     template <class T>
     void push(T &&val);
 
-    int defNamespaces(std::vector<std::string> const &ns);
+    template <class T>
+    int defNamespaces();
+
+    int defNamespaces(std::vector<std::string> const &path);
+
+    template <class T>
+    void pushClass();
+
+    void pushClass(details::ClassPlan const &plan);
+    void registerPlan(details::ClassPlan const &plan);
+    void linkPrototype(int classIdx);
+
+    template <class T>
+    void pushRegisteredPrototype();
     void rethrowDukError();
     void assignSelf();
+    void internKeys();
+
+    static duk_bool_t interruptHook(void *udata);
 };
 
 }
@@ -11,7 +11,10 @@
 #include "Type.h"
 #include "Constructor.h"
 #include "PushConstructorInspector.h"
+#include "Method.h"
+#include "Prototype.h"
 #include "Exceptions.h"
+#include "Tracer.h"
 
 namespace duk {
 
@@ -21,19 +24,45 @@ static void fatal_handler(void *udata, const char *msg) {
     throw DuktapeException(msg);
 }
 
-inline Context::Context(std::string const &scriptId) : _ctx(nullptr), _scriptId(scriptId) {
-    _ctx = duk_create_heap(NULL, NULL, NULL, this, fatal_handler);
+inline Context::Context(std::string const &scriptId)
+    : _heapData(new details::HeapData()), _ctx(nullptr), _current(nullptr), _scriptId(scriptId) {
+    _ctx = duk_create_heap(NULL, NULL, NULL, _heapData.get(), fatal_handler);
+    _current = _ctx;
     assignSelf();
+    internKeys();
+}
+
+inline Context::Context(ContextOptions const &options, std::string const &scriptId)
+    : Context(scriptId) {
+    _classRegistration = options.classRegistration;
+
+    if (options.registeredTypes) {
+        for (const details::ClassPlan *plan : details::ClassPlans::Instance().snapshot()) {
+            registerPlan(*plan);
+        }
+    }
 }
 
 inline Context::~Context() {
-    if (_ctx) {
+    if (_current) {
+        if (_heapData->gcDeferCount > 0) {
+            duk_cpp_gc_allow(_ctx);
+        }
         duk_destroy_heap(_ctx);
     }
 }
 
-inline Context::Context(Context &&that) noexcept : _ctx(that._ctx), _scriptId(that._scriptId) {
+inline Context::Context(Context &&that) noexcept
+    : _heapData(std::move(that._heapData)), _ctx(that._ctx), _current(that._current), _scriptId(that._scriptId),
+      _boxCounter(that._boxCounter.load()), _boxes(std::move(that._boxes)), _objectRefCounter(that._objectRefCounter),
+      _classes(std::move(that._classes)), _lazyClasses(std::move(that._lazyClasses)),
+      _ancestorClasses(std::move(that._ancestorClasses)),
+      _classRegistration(that._classRegistration) {
+    // BorrowScope refers to the context it was opened on, it can't be moved
+    assert(!that._borrowScope);
+
     that._ctx = nullptr;
+    that._current = nullptr;
     assignSelf();
 }
 
@@ -42,9 +71,29 @@ inline Context &Context::operator=(Context &&that) noexcept {
         return *this;
     }
 
+    // BorrowScope refers to the context it was opened on, it can't be moved
+    assert(!this->_borrowScope && !that._borrowScope);
+
+    if (this->_ctx) {
+        if (this->_heapData->gcDeferCount > 0) {
+            duk_cpp_gc_allow(this->_ctx);
+        }
+        duk_destroy_heap(this->_ctx);
+    }
+
+    this->_heapData = std::move(that._heapData);
     this->_ctx = that._ctx;
+    this->_current = that._current;
     this->_scriptId = std::move(that._scriptId);
+    this->_boxCounter = that._boxCounter.load();
+    this->_boxes = std::move(that._boxes);
+    this->_objectRefCounter = that._objectRefCounter;
+    this->_classes = std::move(that._classes);
+    this->_lazyClasses = std::move(that._lazyClasses);
+    this->_ancestorClasses = std::move(that._ancestorClasses);
+    this->_classRegistration = that._classRegistration;
     that._ctx = nullptr;
+    that._current = nullptr;
 
     assignSelf();
 
@@ -62,58 +111,53 @@ inline BoxBase & Context::getBox(int key) const {
 }
 
 inline void Context::removeBox(int key) {
-    _boxes.erase(key);
-}
-
-inline int Context::defNamespaces(std::vector<std::string> const &namespaces) {
-    int depth = 0;
-
-    if (namespaces.size() > 1) {
-        for (int i = 0; i < namespaces.size() - 1; i++) {
-            auto const &ns = namespaces[i];
-
-            duk_get_prop_string(_ctx, -1, ns.c_str());
-            bool isDefined = ! bool(duk_is_undefined(_ctx, -1));
-            duk_pop(_ctx);
-
-            if (!isDefined) {
-                duk_push_object(_ctx);
-                duk_put_prop_string(_ctx, -2, ns.c_str());
-            }
-
-            duk_get_prop_string(_ctx, -1, ns.c_str());
-            depth += 1;
-        }
-    }
-
-    return depth;
+    _heapData->boxesReleased += _boxes.erase(key);
 }
 
 inline void Context::evalStringNoRes(const char *str) {
-    duk_int_t ret = duk_peval_string_noresult(_ctx, str);
+    ThreadScope scope(*this, _current);
+    details::TraceScope trace("evalString", "eval");
+    duk_int_t ret = duk_peval_string_noresult(_current, str);
+    scope.restore();
     if (ret != 0) {
         rethrowDukError();
     }
 }
 
 inline void Context::rethrowDukError() {
-    printf("%d\n", duk_get_top(_ctx));
-    const char *errorMessage = duk_safe_to_string(_ctx, -1);
+    printf("%d\n", duk_get_top(_current));
+    const char *errorMessage = duk_safe_to_string(_current, -1);
     throw ScriptEvaluationExcepton(std::string(errorMessage));
 }
 
 inline Context& Context::GetSelfFromContext(duk_context *d) {
-    duk_push_global_stash(d);
-    duk_get_prop_string(d, -1, "self_ptr");
-    duk::Context *ctx = reinterpret_cast<duk::Context*>(duk_get_pointer(d, -1));
-    duk_pop_2(d);
-    return *ctx;
+    return *details::GetHeapData(d).self;
 }
 
 inline void Context::assignSelf() {
+    _heapData->self = this;
+}
+
+inline void Context::internKeys() {
     duk_push_global_stash(_ctx);
-    duk_push_pointer(_ctx, this);
-    duk_put_prop_string(_ctx, -2, "self_ptr");
+
+    // interned key strings are kept reachable from the stash
+    duk_push_array(_ctx);
+    for (std::size_t i = 0; i < std::size_t(details::HiddenKey::Count); ++i) {
+        duk_push_string(_ctx, details::HiddenKeyName(details::HiddenKey(i)));
+        _heapData->keys[i] = duk_get_heapptr(_ctx, -1);
+        duk_put_prop_index(_ctx, -2, duk_uarridx_t(i));
+    }
+    duk_put_prop_string(_ctx, -2, "\xff" "keys");
+
+    duk_push_object(_ctx);
+    _heapData->refs = duk_get_heapptr(_ctx, -1);
+    duk_put_prop_string(_ctx, -2, "refs");
+
+    duk_push_array(_ctx);
+    _heapData->prototypeStore = duk_get_heapptr(_ctx, -1);
+    details::PutHiddenProp(_ctx, -2, details::HiddenKey::Prototypes);
+
     duk_pop(_ctx);
 }
 
@@ -121,116 +165,495 @@ inline int Context::stashRef(int stackIndex) {
     int key = _objectRefCounter;
     ++ _objectRefCounter;
 
-    duk_push_global_stash(_ctx);
-    if (!duk_has_prop_string(_ctx, -1, "refs")) {
-        duk_push_object(_ctx);
-        duk_put_prop_string(_ctx, -2, "refs");
-    }
+    int idx = duk_normalize_index(_current, stackIndex);
 
-    duk_get_prop_string(_ctx, -1, "refs");
-    duk_dup(_ctx, stackIndex < 0 ? stackIndex - 2 : stackIndex);
-    duk_put_prop_index(_ctx, -2, (duk_uarridx_t) key);
+    duk_push_heapptr(_current, _heapData->refs);
+    duk_dup(_current, idx);
+    duk_put_prop_index(_current, -2, (duk_uarridx_t) key);
 
-    duk_pop_2(_ctx); // refs + global stash
+    duk_pop(_current);
 
     return key;
 }
 
 inline void Context::unstashRef(int refKey) {
-    duk_push_global_stash(_ctx);
+    duk_push_heapptr(_current, _heapData->refs);
+    duk_del_prop_index(_current, -1, duk_uarridx_t(refKey));
+    duk_pop(_current);
+}
 
-    assert(duk_has_prop_string(_ctx, -1, "refs"));
-    duk_get_prop_string(_ctx, -1, "refs");
+inline void Context::getRef(int key) {
+    duk_push_heapptr(_current, _heapData->refs);
 
-    duk_del_prop_index(_ctx, -1, duk_uarridx_t(refKey));
+    assert(duk_has_prop_index(_current, -1, duk_uarridx_t(key)));
+    duk_get_prop_index(_current, -1, duk_uarridx_t(key));
 
-    duk_pop_2(_ctx);
+    duk_remove(_current, -2);
 }
 
-inline void Context::getRef(int key) {
-    duk_push_global_stash(_ctx);
+inline void Context::setInterruptHandler(bool (*handler)(void *data), void *data) {
+    _heapData->interruptHandler = handler;
+    _heapData->interruptData = data;
+    _heapData->interruptHook = handler ? interruptHook : nullptr;
+}
+
+inline duk_bool_t Context::interruptHook(void *udata) {
+    auto *heapData = reinterpret_cast<details::HeapData*>(udata);
+    return heapData->interruptHandler(heapData->interruptData) ? 1 : 0;
+}
 
-    assert(duk_has_prop_string(_ctx, -1, "refs"));
-    duk_get_prop_string(_ctx, -1, "refs");
+inline GcStats Context::collectGarbage(GcMode mode) {
+    details::TraceScope trace("collectGarbage", "gc");
 
-    assert(duk_has_prop_index(_ctx, -1, duk_uarridx_t(key)));
-    duk_get_prop_index(_ctx, -1, duk_uarridx_t(key));
+    GcStats stats;
+    std::size_t objects = duk_cpp_heap_object_count(_ctx);
+    std::size_t finalizers = _heapData->finalizersRun;
+    std::size_t boxes = _heapData->boxesReleased;
+
+    auto start = std::chrono::steady_clock::now();
+
+    // deferred collection is prevented in duktape, lift it for explicit collection
+    if (_heapData->gcDeferCount > 0) {
+        duk_cpp_gc_allow(_ctx);
+    }
 
-    duk_swap_top(_ctx, -3);
+    duk_uint_t flags = mode == GcMode::Compact ? DUK_GC_COMPACT : 0;
+    duk_gc(_ctx, flags);
+    duk_gc(_ctx, flags);
 
-    duk_pop_2(_ctx);
+    if (_heapData->gcDeferCount > 0) {
+        duk_cpp_gc_prevent(_ctx);
+    }
+
+    stats.duration = std::chrono::steady_clock::now() - start;
+
+    std::size_t objectsLeft = duk_cpp_heap_object_count(_ctx);
+    stats.objectsFreed = objects > objectsLeft ? objects - objectsLeft : 0;
+    stats.finalizersRun = _heapData->finalizersRun - finalizers;
+    stats.boxesReleased = _heapData->boxesReleased - boxes;
+
+    return stats;
 }
 
-template <class T>
-inline void Context::addGlobal(const char *name, T &&val) {
-    duk_push_global_object(_ctx);
-    push(std::forward<T>(val));
-    duk_put_prop_string(_ctx, -2, name);
-    duk_pop(_ctx);
+inline void Context::deferGc() {
+    if (_heapData->gcDeferCount++ == 0) {
+        duk_cpp_gc_prevent(_ctx);
+    }
 }
 
-template <class T>
-inline void Context::push(T &&val) {
-   Type<ClearType<T>>::push(*this, std::forward<T>(val));
+inline void Context::resumeGc() {
+    assert(_heapData->gcDeferCount > 0);
+    if (--_heapData->gcDeferCount == 0) {
+        duk_cpp_gc_allow(_ctx);
+    }
 }
 
-template <class T>
-inline void Context::registerClass() {
-    duk_push_global_object(_ctx);
+inline Context::BorrowScope::BorrowScope(Context &ctx) : _ctx(ctx), _prev(ctx._borrowScope) {
+    _ctx._borrowScope = this;
+}
 
-    auto namespaces = splitNamespaces(std::string(GetClassName<T>()));
-    int depth = defNamespaces(namespaces);
+inline Context::BorrowScope::~BorrowScope() {
+    _ctx._borrowScope = _prev;
 
-    details::PushConstructorInspector i(*this);
-    Inspect<T>::inspect(i);
+    if (_refKey < 0) {
+        return;
+    }
+
+    // null `obj_ptr` of every tracked wrapper, so that bindings raise TypeError instead of using dangling pointer
+    _ctx.getRef(_refKey);
+    for (duk_uarridx_t i = 0; i < _count; ++i) {
+        duk_get_prop_index(_ctx, -1, i);
+        details::ResetNativeRef(_ctx, -1);
+        duk_pop(_ctx);
+    }
+    duk_pop(_ctx);
 
-    duk_put_prop_string(_ctx, -2, namespaces.back().c_str());
-    duk_pop_n(_ctx, depth + 1);
+    _ctx.unstashRef(_refKey);
 }
 
-template <class T>
-inline void Context::evalString(T &res, const char *str) {
-    duk_int_t ret = duk_peval_string(_ctx, str);
-    if (ret != 0) {
-        rethrowDukError();
+inline void Context::BorrowScope::track(int index) {
+    int idx = duk_normalize_index(_ctx, index);
+
+    if (_refKey < 0) {
+        duk_push_array(_ctx);
+        _refKey = _ctx.stashRef(-1);
+        duk_pop(_ctx);
     }
 
-    Type<T>::get(*this, res, -1);
+    _ctx.getRef(_refKey);
+    duk_dup(_ctx, idx);
+    duk_put_prop_index(_ctx, -2, _count++);
     duk_pop(_ctx);
 }
 
+inline void Context::CountFinalizer(duk_context *d) {
+    duk_memory_functions funcs;
+    duk_get_memory_functions(d, &funcs);
+    reinterpret_cast<details::HeapData*>(funcs.udata)->finalizersRun += 1;
+}
+
+inline void Context::pushStashedFunction(details::HiddenKey key, const char *src) {
+    duk_push_global_stash(_current);
+    if (!details::GetHiddenProp(_current, -1, key)) {
+        duk_pop(_current);
+        duk_eval_string(_current, src);
+        duk_dup_top(_current);
+        details::PutHiddenProp(_current, -3, key);
+    }
+    duk_remove(_current, -2);
+}
+
+inline details::RegisteredClass const * Context::registeredClass(std::type_index type) {
+    auto it = _classes.find(type);
+    if (it != _classes.end()) {
+        return &it->second;
+    }
+
+    auto lazy = _lazyClasses.find(type);
+    if (lazy == _lazyClasses.end()) {
+        return nullptr;
+    }
+
+    lazy->second.registerPrototype(*this);
+    it = _classes.find(type);
+    return it != _classes.end() ? &it->second : nullptr;
+}
+
+inline details::RegisteredClass const * Context::registeredAncestor(std::type_index dynamicType, void *obj,
+                                                                    const details::NativeType *staticType) {
+    auto &cache = _ancestorClasses[dynamicType];
+    auto cached = cache.find(staticType);
+    if (cached != cache.end()) {
+        return cached->second;
+    }
+
+    // depth of registered class below static type, the deepest one the object is an instance of wins
+    const std::type_index *found = nullptr;
+    int foundDepth = -1;
+
+    auto check = [&] (std::type_index const &type, const details::NativeType *nativeType) {
+        int depth = 0;
+        const details::NativeType *t = nativeType;
+        while (t && t != staticType) {
+            t = t->base;
+            depth += 1;
+        }
+
+        if (t && depth > foundDepth && details::CastToDerived(obj, staticType, nativeType)) {
+            found = &type;
+            foundDepth = depth;
+        }
+    };
+
+    for (auto const &cls : _classes) {
+        check(cls.first, cls.second.type);
+    }
+    for (auto const &cls : _lazyClasses) {
+        check(cls.first, cls.second.type);
+    }
+
+    details::RegisteredClass const *res = found ? registeredClass(*found) : nullptr;
+    cache[staticType] = res;
+    return res;
+}
+
+template <class T>
+inline void Context::addGlobal(const char *name, T &&val) {
+    push(std::forward<T>(val));
+    duk_put_global_string(_current, name);
+}
+
+template <class T>
+inline void Context::push(T &&val) {
+   Type<ClearType<T>>::push(*this, std::forward<T>(val));
+}
+
 namespace details {
 
+/**
+ * Defines constants and static methods of a class as read-only properties of its constructor
+ */
 class ConstantsInspector: public EmptyInspector {
 public:
-    ConstantsInspector(duk::Context &d, int objIdx) : _objIdx(objIdx),_d(d) { }
+    ConstantsInspector(duk::Context &d, int objIdx, const char *className)
+        : _objIdx(objIdx), _d(d), _className(className) { }
 
     template<typename T>
     void constant(const char *name, T value) {
+        duk_push_string(_d, name);
         Type<T>::push(_d, value);
-        duk_put_prop_string(_d, _objIdx, name);
+        defineReadOnly();
+    }
+
+    template <class R, class ... A>
+    void staticMethod(const char *name, R(*func)(A...)) {
+        duk_push_string(_d, name);
+        StaticFunction<R, A...>::push(_d, func);
+        AttachBindingStats(_d, -1, _className, name);
+        AttachTraceName(_d, -1, _className, name);
+        defineReadOnly();
     }
 
 private:
     int _objIdx;
     duk::Context &_d;
+    const char *_className;
+
+    void defineReadOnly() {
+        duk_def_prop(
+            _d,
+            _objIdx,
+            DUK_DEFPROP_HAVE_VALUE |
+            DUK_DEFPROP_HAVE_WRITABLE |
+            DUK_DEFPROP_HAVE_CONFIGURABLE |
+            DUK_DEFPROP_SET_ENUMERABLE
+        );
+    }
 };
 
+/**
+ * Accessor of lazily registered class T, replaces itself with the class on first access
+ */
+template <class T>
+struct LazyClass {
+    typedef ClassPath<T> Path;
+
+    static duk_ret_t get(duk_context *d) {
+        Context &ctx = Context::GetSelfFromContext(d);
+        Context::ThreadScope scope(ctx, d);
+        TraceScope trace(ClassName<T>::value, "register class");
+
+        duk_push_this(d);
+        ctx.pushClass<T>();
+        define(d);
+        return 1;
+    }
+
+    static duk_ret_t set(duk_context *d) {
+        duk_push_this(d);
+        duk_dup(d, 0);
+        define(d);
+        return 0;
+    }
+
+    static void registerPrototype(Context &ctx) {
+        ctx.pushRegisteredPrototype<T>();
+        duk_pop(ctx);
+    }
+
+private:
+    /**
+     * Replace accessor of `this` (below the top) with data property holding the value at the top
+     */
+    static void define(duk_context *d) {
+        duk_push_lstring(d, Path::data(Path::size - 1), Path::length(Path::size - 1));
+        duk_dup(d, -2);
+        duk_def_prop(d, -4,
+            DUK_DEFPROP_HAVE_VALUE |
+            DUK_DEFPROP_SET_WRITABLE |
+            DUK_DEFPROP_SET_ENUMERABLE |
+            DUK_DEFPROP_SET_CONFIGURABLE
+        );
+    }
+};
+
+}
+
+template <class T>
+inline int Context::defNamespaces() {
+    typedef details::ClassPath<T> Path;
+
+    for (std::size_t i = 0; i + 1 < Path::size; ++i) {
+        if (!duk_get_prop_lstring(_current, -1, Path::data(i), Path::length(i))) {
+            duk_pop(_current);
+            duk_push_object(_current);
+            duk_dup_top(_current);
+            duk_put_prop_lstring(_current, -3, Path::data(i), Path::length(i));
+        }
+    }
+
+    return int(Path::size - 1);
+}
+
+template <class T>
+inline void Context::registerClass() {
+    typedef details::ClassPath<T> Path;
+
+    _ancestorClasses.clear();
+
+    if (const details::ClassPlan *plan = details::ClassPlanOf<T>::get()) {
+        registerPlan(*plan);
+        return;
+    }
+
+    duk_push_global_object(_current);
+    int depth = defNamespaces<T>();
+
+    duk_push_lstring(_current, Path::data(Path::size - 1), Path::length(Path::size - 1));
+
+    if (_classRegistration == ClassRegistration::Lazy) {
+        duk_push_c_function(_current, details::LazyClass<T>::get, 0);
+        duk_push_c_function(_current, details::LazyClass<T>::set, 1);
+        duk_def_prop(_current, -4,
+            DUK_DEFPROP_HAVE_GETTER |
+            DUK_DEFPROP_HAVE_SETTER |
+            DUK_DEFPROP_SET_ENUMERABLE |
+            DUK_DEFPROP_SET_CONFIGURABLE
+        );
+        _lazyClasses[std::type_index(typeid(T))] = LazyClassEntry {
+            &details::LazyClass<T>::registerPrototype, details::NativeTypeOf<T>::get()
+        };
+    }
+    else {
+        pushClass<T>();
+        duk_put_prop(_current, -3);
+    }
+
+    duk_pop_n(_current, depth + 1);
+}
+
+template <class T>
+inline void Context::pushRegisteredPrototype() {
+    // prototype is kept in the global stash, so its heap pointer stays valid
+    details::PushPrototype<T>(*this);
+    _classes[std::type_index(typeid(T))] = details::RegisteredClass {
+        duk_get_heapptr(_current, -1), details::NativeTypeOf<T>::get()
+    };
+}
+
+template <class T>
+inline void Context::pushClass() {
+    if (const details::ClassPlan *plan = details::ClassPlanOf<T>::get()) {
+        pushClass(*plan);
+        return;
+    }
+
+    details::PushConstructorInspector i(*this);
+    Inspect<T>::inspect(i);
+
+    // classes without constructor still get an object for constants and static methods
+    if (!i.hasConstructor()) {
+        duk_push_object(_current);
+    }
+
+    auto classIdx = duk_get_top_index(_current);
+
+    details::ConstantsInspector c(*this, classIdx, ClassName<T>::value);
+    Inspect<T>::inspect(c);
+
+    pushRegisteredPrototype<T>();
+
+    if (i.hasConstructor()) {
+        linkPrototype(classIdx);
+    }
+    duk_pop(_current);
+}
+
+inline void Context::pushClass(details::ClassPlan const &plan) {
+    if (plan.constructor.isSet()) {
+        details::PushPlanFunction(*this, plan.constructor);
+    }
+    else if (plan.pushConstructor) {
+        plan.pushConstructor(*this);
+    }
+    else {
+        duk_push_object(_current);
+    }
+
+    auto classIdx = duk_get_top_index(_current);
+    details::ApplyPlanSteps(*this, classIdx, plan.statics);
+
+    plan.pushPrototype(*this);
+    _classes[plan.type] = details::RegisteredClass { duk_get_heapptr(_current, -1), plan.nativeType };
+
+    if (plan.hasConstructor()) {
+        linkPrototype(classIdx);
+    }
+    duk_pop(_current);
+}
+
+/**
+ * Link constructor at `classIdx` and prototype at the top, so that `instanceof` works for wrappers
+ */
+inline void Context::linkPrototype(int classIdx) {
+    duk_push_string(_current, "prototype");
+    duk_dup(_current, -2);
+    duk_def_prop(_current, classIdx, DUK_DEFPROP_HAVE_VALUE | DUK_DEFPROP_SET_WRITABLE | DUK_DEFPROP_SET_CONFIGURABLE);
+    duk_push_string(_current, "constructor");
+    duk_dup(_current, classIdx);
+    duk_def_prop(_current, -3, DUK_DEFPROP_HAVE_VALUE | DUK_DEFPROP_SET_WRITABLE | DUK_DEFPROP_SET_CONFIGURABLE);
+}
+
+inline int Context::defNamespaces(std::vector<std::string> const &path) {
+    for (std::size_t i = 0; i + 1 < path.size(); ++i) {
+        if (!duk_get_prop_lstring(_current, -1, path[i].data(), path[i].size())) {
+            duk_pop(_current);
+            duk_push_object(_current);
+            duk_dup_top(_current);
+            duk_put_prop_lstring(_current, -3, path[i].data(), path[i].size());
+        }
+    }
+
+    return int(path.size() - 1);
+}
+
+/**
+ * Same as `registerClass` for class recorded in binding plan
+ */
+inline void Context::registerPlan(details::ClassPlan const &plan) {
+    _ancestorClasses.clear();
+
+    duk_push_global_object(_current);
+    int depth = defNamespaces(plan.path);
+
+    duk_push_lstring(_current, plan.path.back().data(), plan.path.back().size());
+
+    if (_classRegistration == ClassRegistration::Lazy) {
+        duk_push_c_function(_current, plan.lazyGet, 0);
+        duk_push_c_function(_current, plan.lazySet, 1);
+        duk_def_prop(_current, -4,
+            DUK_DEFPROP_HAVE_GETTER |
+            DUK_DEFPROP_HAVE_SETTER |
+            DUK_DEFPROP_SET_ENUMERABLE |
+            DUK_DEFPROP_SET_CONFIGURABLE
+        );
+        _lazyClasses[plan.type] = LazyClassEntry { plan.registerPrototype, plan.nativeType };
+    }
+    else {
+        pushClass(plan);
+        duk_put_prop(_current, -3);
+    }
+
+    duk_pop_n(_current, depth + 1);
+}
+
+template <class T>
+inline void Context::evalString(T &res, const char *str) {
+    ThreadScope scope(*this, _current);
+    details::TraceScope trace("evalString", "eval");
+    duk_int_t ret = duk_peval_string(_current, str);
+    scope.restore();
+    if (ret != 0) {
+        rethrowDukError();
+    }
+
+    Type<T>::get(*this, res, -1);
+    duk_pop(_current);
 }
 
 template <class T>
 inline void Context::getGlobal(const char *name, T &res) {
-    duk_push_global_object(_ctx);
-    duk_get_prop_string(_ctx, -1, name);
+    duk_push_global_object(_current);
+    duk_get_prop_string(_current, -1, name);
 
-    if (duk_is_undefined(_ctx, -1)) {
-        duk_pop_2(_ctx);
+    if (duk_is_undefined(_current, -1)) {
+        duk_pop_2(_current);
         throw KeyError(std::string(name) + " is undefined");
     }
 
     Type<T>::get(*this, res, -1);
 
-    duk_pop_2(_ctx);
+    duk_pop_2(_current);
 }
 
 }
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <duktape.h>
+
+#include "Type.h"
+
+namespace duk {
+
+class Context;
+
+/**
+ * @brief Script coroutine running in its own duktape thread.
+ * @details Coroutine starts on the first `resume` call and runs until
+ *          the script calls `Duktape.Thread.yield(value)` or returns.
+ *          All coroutines of a context share its global object,
+ *          so a single context can multiplex many suspended scripts.
+ *
+ * Coroutine can be obtained from any javascript function:
+ * @code
+ * duk::Coroutine co;
+ * ctx.evalString(co, "(function (v) { while (true) { v = Duktape.Thread.yield(v * 2); } })");
+ * int res = 0;
+ * co.resume(res, 5); // res == 10
+ * @endcode
+ */
+class Coroutine {
+public:
+    Coroutine() = default;
+
+    /**
+     * @brief Spawn coroutine
+     * @param d duktape context
+     * @param funcIndex index of javascript function in the current stack
+     */
+    Coroutine(Context &d, int funcIndex);
+
+    ~Coroutine();
+
+    Coroutine(Coroutine const &) = delete;
+    Coroutine & operator = (Coroutine const &) = delete;
+
+    Coroutine(Coroutine &&that) noexcept;
+    Coroutine & operator = (Coroutine &&that) noexcept;
+
+    /**
+     * @brief Resume coroutine and get yielded (or returned) value
+     * @tparam R result type
+     * @tparam A type of the value passed to coroutine (at most one)
+     * @param[out] res value passed to `Duktape.Thread.yield` or returned from coroutine function
+     * @param[in] value value returned from `Duktape.Thread.yield` inside coroutine
+     *                  (or passed as an argument to coroutine function on the first resume)
+     * @throws ScriptEvaluationExcepton if coroutine throws an error
+     */
+    template <class R, class ... A>
+    void resume(R &res, A && ... value);
+
+    /**
+     * @brief Resume coroutine and ignore yielded (or returned) value
+     * @see resume
+     */
+    template <class ... A>
+    void resumeNoRes(A && ... value);
+
+    /**
+     * @brief Check if coroutine function has returned (or thrown an error)
+     */
+    bool isDone() const { return _done; }
+
+    /**
+     * @brief Check if coroutine holds a thread
+     */
+    bool isValid() const { return _d != nullptr; }
+
+private:
+    duk_context *_d = nullptr;
+    int _refKey = -1;
+    bool _done = false;
+
+    template <class ... A>
+    void doResume(Context &d, A && ... value);
+
+    void release();
+};
+
+template <>
+struct Type<Coroutine> {
+    static void push(duk::Context &d, Coroutine const &val);
+
+    /**
+     * Spawn coroutine from function at specified index
+     * @param[in] d duktape context
+     * @param[out] val coroutine
+     * @param[in] index function index at duktape stack
+     */
+    static void get(duk::Context &d, Coroutine &val, int index);
+
+    static constexpr bool isPrimitive() { return true; };
+};
+
+}
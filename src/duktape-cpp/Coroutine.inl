@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cassert>
+#include <string>
+#include <utility>
+
+#include "Coroutine.h"
+#include "Context.h"
+#include "Exceptions.h"
+
+#include "./Utils/Helpers.h"
+
+namespace duk {
+
+namespace details {
+
+/**
+ * Wraps function into a new thread. Thread is marked with `done` flag
+ * when the function returns, because duktape doesn't expose thread state.
+ */
+static const char CoroutineSpawnSrc[] =
+    "(function (fn) {\n"
+    "    var t = new Duktape.Thread(function (v) {\n"
+    "        var r = fn(v);\n"
+    "        t.done = true;\n"
+    "        return r;\n"
+    "    });\n"
+    "    return t;\n"
+    "})";
+
+/**
+ * `Duktape.Thread.resume` must be called from javascript function
+ */
+static const char CoroutineResumeSrc[] =
+    "(function (t, v) { return Duktape.Thread.resume(t, v); })";
+
+inline void PushCoroutineValue(duk::Context &d) {
+    duk_push_undefined(d);
+}
+
+template <class A>
+inline void PushCoroutineValue(duk::Context &d, A &&value) {
+    Type<ClearType<A>>::push(d, std::forward<A>(value));
+}
+
+}
+
+inline Coroutine::Coroutine(Context &d, int funcIndex) {
+    Context::ThreadScope scope(d, d.current());
+
+    int funcIdx = duk_normalize_index(d, funcIndex);
+    duk_require_function(d, funcIdx);
+
+    d.pushStashedFunction(details::HiddenKey::CoroSpawn, details::CoroutineSpawnSrc);
+    duk_dup(d, funcIdx);
+    duk_call(d, 1);
+
+    _refKey = d.stashRef(-1);
+    _d = d.ptr();
+    duk_pop(d);
+}
+
+inline Coroutine::~Coroutine() {
+    release();
+}
+
+inline Coroutine::Coroutine(Coroutine &&that) noexcept
+    : _d(that._d), _refKey(that._refKey), _done(that._done) {
+    that._d = nullptr;
+    that._refKey = -1;
+}
+
+inline Coroutine & Coroutine::operator = (Coroutine &&that) noexcept {
+    if (this == &that) {
+        return *this;
+    }
+
+    release();
+
+    _d = that._d;
+    _refKey = that._refKey;
+    _done = that._done;
+
+    that._d = nullptr;
+    that._refKey = -1;
+
+    return *this;
+}
+
+inline void Coroutine::release() {
+    if (_d) {
+        Context &ctx = Context::GetSelfFromContext(_d);
+        ctx.unstashRef(_refKey);
+        _d = nullptr;
+        _refKey = -1;
+    }
+}
+
+template <class ... A>
+inline void Coroutine::doResume(Context &d, A && ... value) {
+    static_assert(sizeof...(A) <= 1, "only one value can be passed to coroutine");
+
+    assert(_d);
+
+    if (_done) {
+        throw DuktapeException("Coroutine is already finished");
+    }
+
+    Context::ThreadScope scope(d, d.current());
+
+    d.pushStashedFunction(details::HiddenKey::CoroResume, details::CoroutineResumeSrc);
+    d.getRef(_refKey);
+    details::PushCoroutineValue(d, std::forward<A>(value)...);
+
+    duk_int_t callRes = duk_pcall(d, 2);
+    scope.restore();
+
+    if (callRes != DUK_EXEC_SUCCESS) {
+        _done = true;
+        std::string error = duk_safe_to_string(d, -1);
+        duk_pop(d);
+        throw ScriptEvaluationExcepton(error);
+    }
+
+    d.getRef(_refKey);
+    duk_get_prop_string(d, -1, "done");
+    _done = bool(duk_to_boolean(d, -1));
+    duk_pop_2(d);
+}
+
+template <class R, class ... A>
+inline void Coroutine::resume(R &res, A && ... value) {
+    Context &d = Context::GetSelfFromContext(_d);
+    Context::ThreadScope scope(d, d.current());
+
+    doResume(d, std::forward<A>(value)...);
+
+    Type<R>::get(d, res, -1);
+    duk_pop(d);
+}
+
+template <class ... A>
+inline void Coroutine::resumeNoRes(A && ... value) {
+    Context &d = Context::GetSelfFromContext(_d);
+    Context::ThreadScope scope(d, d.current());
+
+    doResume(d, std::forward<A>(value)...);
+
+    duk_pop(d);
+}
+
+inline void Type<Coroutine>::push(duk::Context &d, Coroutine const &val) {
+    assert(false && "Push coroutine to duktape stack is not implemented");
+}
+
+inline void Type<Coroutine>::get(duk::Context &d, Coroutine &val, int index) {
+    val = Coroutine(d, index);
+}
+
+}
@@ -2,6 +2,12 @@
 
 #include "./Types/All.h"
 #include "./Context.inl"
+#include "./TypeRegistry.h"
 #include "./Constructor.inl"
 #include "./PushObjectInspector.inl"
+#include "./Coroutine.inl"
+#include "./EventLoop.inl"
+#include "./Profiler.inl"
+#include "./Handle.inl"
+#include "./JSObject.inl"
 #include "./Exceptions.h"
\ No newline at end of file
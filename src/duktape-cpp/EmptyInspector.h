@@ -24,11 +24,26 @@ public:
     template <class C, class R, class ... A>
     void method(const char *name, R(C::*method)(A...) const) {}
 
+    template <class M1, class M2, class ... M>
+    void method(const char *name, M1 method1, M2 method2, M ... methods) {}
+
+    template <class R, class ... A>
+    void staticMethod(const char *name, R(*func)(A...)) {}
+
+    template <class C, class R, class ... A>
+    void asyncMethod(const char *name, R(C::*method)(A...)) {}
+
+    template <class C, class R, class ... A>
+    void asyncMethod(const char *name, R(C::*method)(A...) const) {}
+
     template <class C, class ... A>
     void construct(std::shared_ptr<C> (*constructor) (A...)) {}
 
     template <class C, class ... A>
     void construct(std::unique_ptr<C> (*constructor) (A...)) {}
+
+    template <class F1, class F2, class ... F>
+    void construct(F1 constructor1, F2 constructor2, F ... constructors) {}
 };
 
 }}
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <duktape.h>
+
+#include "ThreadPool.h"
+
+namespace duk {
+
+class Context;
+
+namespace details {
+
+/**
+ * Wakes up the thread running event loop, can be notified from any thread
+ */
+class WakeUpSignal {
+public:
+    void notify() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _signalled = true;
+        }
+        _cv.notify_one();
+    }
+
+    /**
+     * Wait until notified or `deadline` is reached and clear the signal
+     */
+    template <class TimePoint>
+    void waitUntil(TimePoint deadline) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (deadline == TimePoint::max()) {
+            _cv.wait(lock, [this] { return _signalled; });
+        }
+        else {
+            _cv.wait_until(lock, deadline, [this] { return _signalled; });
+        }
+        _signalled = false;
+    }
+
+private:
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    bool _signalled { false };
+};
+
+/**
+ * Future waiting to be resolved on the thread running event loop
+ */
+class PendingFutureBase {
+public:
+    PendingFutureBase(int settleRef, int keepAliveRef, bool polled)
+        : _settleRef(settleRef), _keepAliveRef(keepAliveRef), _polled(polled) {}
+    virtual ~PendingFutureBase() = default;
+
+    int settleRef() const { return _settleRef; }
+
+    /**
+     * Reference to value kept alive until the future is settled or -1
+     */
+    int keepAliveRef() const { return _keepAliveRef; }
+
+    /**
+     * Future doesn't wake up the loop when it's ready, so the loop checks it periodically
+     */
+    bool polled() const { return _polled; }
+
+    virtual bool isReady() const = 0;
+
+    /**
+     * Push success flag and result (or error message) to stack
+     */
+    virtual void pushResult(duk::Context &d) = 0;
+
+private:
+    int _settleRef;
+    int _keepAliveRef;
+    bool _polled;
+};
+
+template <class R>
+class PendingFuture;
+
+}
+
+/**
+ * @brief Timers and microtask queue for scripts hosted in a context
+ * @details Event loop defines `setTimeout`, `setInterval`, `clearTimeout`,
+ *          `clearInterval` and `queueMicrotask` global functions.
+ *          Callbacks are kept as stashed function references (see `Context::stashRef`),
+ *          timers are kept in a binary min-heap, microtasks in a FIFO queue.
+ *          Async methods are resolved by the loop (see `pushTask`), it sleeps until they are done.
+ *          Event loop must not outlive its context and must be driven from the thread owning the context.
+ */
+class EventLoop {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * @brief Create event loop and bind it to context
+     * @param ctx duktape context
+     */
+    explicit EventLoop(Context &ctx);
+    ~EventLoop();
+
+    EventLoop(const EventLoop &) = delete;
+    EventLoop & operator = (const EventLoop &) = delete;
+
+    /**
+     * @brief Get event loop bound to context
+     * @returns pointer to event loop or nullptr if context has no event loop
+     */
+    static EventLoop * GetFromContext(duk_context *d);
+
+    /**
+     * @brief Schedule javascript function call
+     * @param funcIndex index of the function in the current stack
+     * @param delay delay before the call
+     * @param repeat call function repeatedly with `delay` interval
+     * @returns timer id
+     */
+    int addTimer(int funcIndex, std::chrono::milliseconds delay, bool repeat);
+
+    /**
+     * @brief Cancel timer
+     * @param id timer id (see `addTimer`)
+     */
+    void removeTimer(int id);
+
+    /**
+     * @brief Add javascript function to the microtask queue
+     * @param funcIndex index of the function in the current stack
+     */
+    void enqueueMicrotask(int funcIndex);
+
+    /**
+     * @brief Push thenable object resolved with future result
+     * @details Script receives an object with `then(onResolve, onReject)` method,
+     *          handlers are called as microtasks on the thread running the loop.
+     *          `std::future` can't notify the loop, so while it is pending the loop
+     *          checks it with growing interval (1 to 64 ms), prefer `pushTask`.
+     * @param future future to wait for
+     * @param keepAliveIndex index of the value referenced until the future is settled, or DUK_INVALID_INDEX
+     */
+    template <class R>
+    void pushFuture(std::future<R> future, duk_idx_t keepAliveIndex = DUK_INVALID_INDEX);
+
+    /**
+     * @brief Run task on the thread pool and push thenable object resolved with its result
+     * @details Same as `pushFuture`, but the task wakes up the loop when it is done,
+     *          so the loop doesn't poll it.
+     * @param task task to run
+     * @param keepAliveIndex index of the value (e.g. receiver of async method) referenced
+     *                       until the task is settled, or DUK_INVALID_INDEX
+     */
+    template <class R>
+    void pushTask(std::packaged_task<R()> task, duk_idx_t keepAliveIndex = DUK_INVALID_INDEX);
+
+    /**
+     * @brief Thread pool used to run async methods (see `PushObjectInspector::asyncMethod`)
+     * @details Pool with default number of threads is created on first use if not set
+     */
+    ThreadPool & threadPool();
+
+    /**
+     * @brief Set thread pool used to run async methods
+     */
+    void setThreadPool(std::shared_ptr<ThreadPool> pool) { _threadPool = std::move(pool); }
+
+    /**
+     * @brief Run single iteration of the loop
+     * @details Runs all queued microtasks, waits for the nearest timer (but not longer than `deadline`)
+     *          and runs timers which are due, each followed by the microtasks it queued.
+     *          Waiting ends early when a task started with `pushTask` is done,
+     *          futures pushed with `pushFuture` are checked periodically.
+     * @param deadline time point to wait until if there are no due timers
+     * @returns true if there are pending timers or microtasks
+     * @throws ScriptEvaluationExcepton if callback throws an error
+     */
+    bool runOnce(Clock::time_point deadline);
+
+    /**
+     * @brief Run loop until there are no pending timers, microtasks and futures
+     * @throws ScriptEvaluationExcepton if callback throws an error
+     */
+    void runUntilIdle();
+
+    /**
+     * @brief Check if there are no pending timers, microtasks and futures
+     */
+    bool isIdle() const { return _timers.empty() && _microtasks.empty() && _futures.empty(); }
+
+private:
+    struct TimerEntry {
+        Clock::time_point due;
+        std::uint64_t seq;
+        int id;
+
+        bool operator > (TimerEntry const &that) const {
+            return due != that.due ? due > that.due : seq > that.seq;
+        }
+    };
+
+    struct Timer {
+        int refKey;
+        Clock::duration interval;
+        bool repeat;
+    };
+
+    Context &_ctx;
+    std::vector<TimerEntry> _heap;
+    std::unordered_map<int, Timer> _timers;
+    std::deque<int> _microtasks;
+    std::vector<std::unique_ptr<details::PendingFutureBase>> _futures;
+    std::shared_ptr<ThreadPool> _threadPool;
+    std::shared_ptr<details::WakeUpSignal> _wakeUp { std::make_shared<details::WakeUpSignal>() };
+    Clock::duration _pollInterval { std::chrono::milliseconds(1) };
+    std::uint64_t _seq { 0 };
+    int _timerCounter { 0 };
+
+    template <class R>
+    void addFuture(std::future<R> future, duk_idx_t keepAliveIndex, bool polled);
+    bool hasPolledFutures() const;
+    void schedule(int id, Clock::time_point due);
+    void compactHeap();
+    void runMicrotasks();
+    void settleFutures();
+    void runTimers(Clock::time_point now);
+    void callRef(int refKey);
+    void installGlobals();
+
+    static duk_ret_t setTimeoutFunc(duk_context *d);
+    static duk_ret_t clearTimeoutFunc(duk_context *d);
+    static duk_ret_t queueMicrotaskFunc(duk_context *d);
+};
+
+}
@@ -0,0 +1,472 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <thread>
+
+#include "EventLoop.h"
+#include "Context.h"
+#include "Exceptions.h"
+#include "Type.h"
+
+#include "./Utils/Helpers.h"
+
+namespace duk {
+
+namespace details {
+
+/**
+ * Longest timer delay in milliseconds (same as in browsers), longer delays are clamped
+ */
+static const double MaxTimerDelay = 2147483647.0;
+
+/**
+ * Creates thenable object and function settling it.
+ * Returns [thenable, settle(ok, value)]
+ */
+static const char DeferredSrc[] =
+    "(function () {\n"
+    "    var handlers = [], state = 0, result;\n"
+    "    function run(h) {\n"
+    "        queueMicrotask(function () {\n"
+    "            var f = h[state - 1];\n"
+    "            if (typeof f === 'function') { f(result); }\n"
+    "        });\n"
+    "    }\n"
+    "    var thenable = {\n"
+    "        then: function (onResolve, onReject) {\n"
+    "            var h = [onResolve, onReject];\n"
+    "            if (state) { run(h); } else { handlers.push(h); }\n"
+    "        }\n"
+    "    };\n"
+    "    function settle(ok, value) {\n"
+    "        state = ok ? 1 : 2;\n"
+    "        result = ok ? value : new Error(value);\n"
+    "        handlers.forEach(run);\n"
+    "        handlers = null;\n"
+    "    }\n"
+    "    return [thenable, settle];\n"
+    "})";
+
+template <class R>
+class PendingFuture: public PendingFutureBase {
+public:
+    PendingFuture(int settleRef, int keepAliveRef, bool polled, std::future<R> future)
+        : PendingFutureBase(settleRef, keepAliveRef, polled), _future(std::move(future)) {}
+
+    bool isReady() const override {
+        return _future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    void pushResult(duk::Context &d) override {
+        try {
+            R res = _future.get();
+            duk_push_true(d);
+            Type<ClearType<R>>::push(d, std::move(res));
+        }
+        catch (std::exception &e) {
+            duk_push_false(d);
+            duk_push_string(d, e.what());
+        }
+        catch (...) {
+            duk_push_false(d);
+            duk_push_string(d, "Unknown error");
+        }
+    }
+
+private:
+    std::future<R> _future;
+};
+
+template <>
+class PendingFuture<void>: public PendingFutureBase {
+public:
+    PendingFuture(int settleRef, int keepAliveRef, bool polled, std::future<void> future)
+        : PendingFutureBase(settleRef, keepAliveRef, polled), _future(std::move(future)) {}
+
+    bool isReady() const override {
+        return _future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    void pushResult(duk::Context &d) override {
+        try {
+            _future.get();
+            duk_push_true(d);
+            duk_push_undefined(d);
+        }
+        catch (std::exception &e) {
+            duk_push_false(d);
+            duk_push_string(d, e.what());
+        }
+        catch (...) {
+            duk_push_false(d);
+            duk_push_string(d, "Unknown error");
+        }
+    }
+
+private:
+    std::future<void> _future;
+};
+
+}
+
+inline EventLoop::EventLoop(Context &ctx) : _ctx(ctx) {
+    installGlobals();
+}
+
+inline EventLoop::~EventLoop() {
+    if (!_ctx.ptr()) {
+        return;
+    }
+
+    for (auto const &timer : _timers) {
+        _ctx.unstashRef(timer.second.refKey);
+    }
+
+    for (int refKey : _microtasks) {
+        _ctx.unstashRef(refKey);
+    }
+
+    for (auto const &f : _futures) {
+        _ctx.unstashRef(f->settleRef());
+        if (f->keepAliveRef() >= 0) {
+            _ctx.unstashRef(f->keepAliveRef());
+        }
+    }
+
+    details::GetHeapData(_ctx).eventLoop = nullptr;
+}
+
+inline EventLoop * EventLoop::GetFromContext(duk_context *d) {
+    return details::GetHeapData(d).eventLoop;
+}
+
+inline void EventLoop::installGlobals() {
+    details::GetHeapData(_ctx).eventLoop = this;
+
+    duk_push_global_object(_ctx);
+
+    // setTimeout and setInterval share implementation, magic tells them apart
+    duk_push_c_function(_ctx, setTimeoutFunc, 2);
+    duk_put_prop_string(_ctx, -2, "setTimeout");
+
+    duk_push_c_function(_ctx, setTimeoutFunc, 2);
+    duk_set_magic(_ctx, -1, 1);
+    duk_put_prop_string(_ctx, -2, "setInterval");
+
+    duk_push_c_function(_ctx, clearTimeoutFunc, 1);
+    duk_put_prop_string(_ctx, -2, "clearTimeout");
+
+    duk_push_c_function(_ctx, clearTimeoutFunc, 1);
+    duk_put_prop_string(_ctx, -2, "clearInterval");
+
+    duk_push_c_function(_ctx, queueMicrotaskFunc, 1);
+    duk_put_prop_string(_ctx, -2, "queueMicrotask");
+
+    duk_pop(_ctx);
+}
+
+inline int EventLoop::addTimer(int funcIndex, std::chrono::milliseconds delay, bool repeat) {
+    if (delay.count() < 0) {
+        delay = std::chrono::milliseconds(0);
+    }
+
+    int id = ++_timerCounter;
+    Timer timer { _ctx.stashRef(funcIndex), delay, repeat };
+    _timers.emplace(id, timer);
+
+    schedule(id, Clock::now() + delay);
+
+    return id;
+}
+
+inline void EventLoop::removeTimer(int id) {
+    auto it = _timers.find(id);
+    if (it == _timers.end()) {
+        return;
+    }
+
+    // heap entry is left in place and skipped when it becomes due
+    _ctx.unstashRef(it->second.refKey);
+    _timers.erase(it);
+
+    // every live timer has exactly one heap entry, the rest are cancelled
+    if (_heap.size() > 2 * _timers.size() + 16) {
+        compactHeap();
+    }
+}
+
+inline void EventLoop::compactHeap() {
+    auto cancelled = [this] (TimerEntry const &entry) { return _timers.find(entry.id) == _timers.end(); };
+    _heap.erase(std::remove_if(_heap.begin(), _heap.end(), cancelled), _heap.end());
+    std::make_heap(_heap.begin(), _heap.end(), std::greater<TimerEntry>());
+}
+
+inline void EventLoop::enqueueMicrotask(int funcIndex) {
+    _microtasks.push_back(_ctx.stashRef(funcIndex));
+}
+
+template <class R>
+inline void EventLoop::pushFuture(std::future<R> future, duk_idx_t keepAliveIndex) {
+    addFuture(std::move(future), keepAliveIndex, true);
+}
+
+template <class R>
+inline void EventLoop::pushTask(std::packaged_task<R()> task, duk_idx_t keepAliveIndex) {
+    auto shared = std::make_shared<std::packaged_task<R()>>(std::move(task));
+    std::future<R> future = shared->get_future();
+
+    // signal is shared, so the task may finish after the loop is destroyed
+    std::shared_ptr<details::WakeUpSignal> wakeUp = _wakeUp;
+    threadPool().post([shared, wakeUp] {
+        (*shared)();
+        wakeUp->notify();
+    });
+
+    addFuture(std::move(future), keepAliveIndex, false);
+}
+
+template <class R>
+inline void EventLoop::addFuture(std::future<R> future, duk_idx_t keepAliveIndex, bool polled) {
+    int keepAliveRef = keepAliveIndex != DUK_INVALID_INDEX ? _ctx.stashRef(keepAliveIndex) : -1;
+
+    _ctx.pushStashedFunction(details::HiddenKey::Deferred, details::DeferredSrc);
+    duk_call(_ctx, 0);
+
+    duk_get_prop_index(_ctx, -1, 1);
+    int settleRef = _ctx.stashRef(-1);
+    duk_pop(_ctx);
+
+    _futures.push_back(std::unique_ptr<details::PendingFutureBase>(
+        new details::PendingFuture<R>(settleRef, keepAliveRef, polled, std::move(future))
+    ));
+
+    // leave thenable on the stack
+    duk_get_prop_index(_ctx, -1, 0);
+    duk_remove(_ctx, -2);
+}
+
+inline ThreadPool & EventLoop::threadPool() {
+    if (!_threadPool) {
+        _threadPool = std::make_shared<ThreadPool>();
+    }
+    return *_threadPool;
+}
+
+inline void EventLoop::schedule(int id, Clock::time_point due) {
+    _heap.push_back(TimerEntry { due, _seq++, id });
+    std::push_heap(_heap.begin(), _heap.end(), std::greater<TimerEntry>());
+}
+
+inline bool EventLoop::runOnce(Clock::time_point deadline) {
+    runMicrotasks();
+    settleFutures();
+
+    // drop cancelled timers from the top of the heap
+    while (!_heap.empty() && _timers.find(_heap.front().id) == _timers.end()) {
+        std::pop_heap(_heap.begin(), _heap.end(), std::greater<TimerEntry>());
+        _heap.pop_back();
+    }
+
+    if (_heap.empty() && _futures.empty()) {
+        return !isIdle();
+    }
+
+    auto now = Clock::now();
+    auto wakeUp = deadline;
+
+    if (!_heap.empty()) {
+        wakeUp = std::min(wakeUp, _heap.front().due);
+    }
+
+    // tasks wake up the loop when they are done, plain futures are polled with growing interval
+    if (hasPolledFutures()) {
+        wakeUp = std::min(wakeUp, now + _pollInterval);
+        _pollInterval = std::min<Clock::duration>(_pollInterval * 2, std::chrono::milliseconds(64));
+    }
+
+    if (wakeUp > now) {
+        _wakeUp->waitUntil(wakeUp);
+        now = Clock::now();
+    }
+
+    settleFutures();
+    runTimers(now);
+
+    return !isIdle();
+}
+
+inline void EventLoop::runUntilIdle() {
+    while (runOnce(Clock::time_point::max())) {
+        // keep running
+    }
+}
+
+inline void EventLoop::runTimers(Clock::time_point now) {
+    // timers scheduled while running callbacks wait for the next iteration
+    std::uint64_t seqLimit = _seq;
+
+    while (!_heap.empty() && _heap.front().due <= now && _heap.front().seq < seqLimit) {
+        int id = _heap.front().id;
+        std::pop_heap(_heap.begin(), _heap.end(), std::greater<TimerEntry>());
+        _heap.pop_back();
+
+        auto it = _timers.find(id);
+        if (it == _timers.end()) {
+            continue;
+        }
+
+        // repeating timers keep their reference until removed
+        int refKey = it->second.refKey;
+        bool once = !it->second.repeat;
+
+        if (once) {
+            _timers.erase(it);
+        }
+        else {
+            schedule(id, now + it->second.interval);
+        }
+
+        try {
+            callRef(refKey);
+        }
+        catch (...) {
+            if (once) {
+                _ctx.unstashRef(refKey);
+            }
+            throw;
+        }
+
+        if (once) {
+            _ctx.unstashRef(refKey);
+        }
+
+        runMicrotasks();
+    }
+}
+
+inline void EventLoop::runMicrotasks() {
+    while (!_microtasks.empty()) {
+        int refKey = _microtasks.front();
+        _microtasks.pop_front();
+
+        try {
+            callRef(refKey);
+        }
+        catch (...) {
+            _ctx.unstashRef(refKey);
+            throw;
+        }
+
+        _ctx.unstashRef(refKey);
+    }
+}
+
+inline bool EventLoop::hasPolledFutures() const {
+    for (auto const &f : _futures) {
+        if (f->polled()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline void EventLoop::settleFutures() {
+    for (std::size_t i = 0; i < _futures.size();) {
+        if (!_futures[i]->isReady()) {
+            ++i;
+            continue;
+        }
+
+        if (_futures[i]->polled()) {
+            _pollInterval = std::chrono::milliseconds(1);
+        }
+
+        std::unique_ptr<details::PendingFutureBase> f = std::move(_futures[i]);
+        _futures.erase(_futures.begin() + i);
+
+        Context::ThreadScope scope(_ctx, _ctx.current());
+
+        _ctx.getRef(f->settleRef());
+        _ctx.unstashRef(f->settleRef());
+        if (f->keepAliveRef() >= 0) {
+            _ctx.unstashRef(f->keepAliveRef());
+        }
+        f->pushResult(_ctx);
+
+        duk_int_t callRes = duk_pcall(_ctx, 2);
+        scope.restore();
+
+        if (callRes != DUK_EXEC_SUCCESS) {
+            std::string error = duk_safe_to_string(_ctx, -1);
+            duk_pop(_ctx);
+            throw ScriptEvaluationExcepton(error);
+        }
+        duk_pop(_ctx);
+
+        runMicrotasks();
+    }
+}
+
+inline void EventLoop::callRef(int refKey) {
+    Context::ThreadScope scope(_ctx, _ctx.current());
+
+    _ctx.getRef(refKey);
+    duk_int_t callRes = duk_pcall(_ctx, 0);
+    scope.restore();
+
+    if (callRes != DUK_EXEC_SUCCESS) {
+        std::string error = duk_safe_to_string(_ctx, -1);
+        duk_pop(_ctx);
+        throw ScriptEvaluationExcepton(error);
+    }
+    duk_pop(_ctx);
+}
+
+inline duk_ret_t EventLoop::setTimeoutFunc(duk_context *d) {
+    EventLoop *loop = GetFromContext(d);
+    if (!loop) {
+        duk_error(d, DUK_ERR_ERROR, "Event loop is destroyed");
+    }
+
+    duk_require_function(d, 0);
+
+    // NaN, negative and infinite delays must not reach duration conversion
+    double delay = duk_get_number(d, 1);
+    if (!(delay > 0)) {
+        delay = 0;
+    }
+    delay = std::min(delay, details::MaxTimerDelay);
+
+    Context::ThreadScope scope(loop->_ctx, d);
+    bool repeat = duk_get_current_magic(d) == 1;
+    int id = loop->addTimer(0, std::chrono::milliseconds((long long)delay), repeat);
+
+    duk_push_int(d, id);
+    return 1;
+}
+
+inline duk_ret_t EventLoop::clearTimeoutFunc(duk_context *d) {
+    EventLoop *loop = GetFromContext(d);
+    if (loop) {
+        loop->removeTimer(duk_get_int(d, 0));
+    }
+    return 0;
+}
+
+inline duk_ret_t EventLoop::queueMicrotaskFunc(duk_context *d) {
+    EventLoop *loop = GetFromContext(d);
+    if (!loop) {
+        duk_error(d, DUK_ERR_ERROR, "Event loop is destroyed");
+    }
+
+    duk_require_function(d, 0);
+
+    Context::ThreadScope scope(loop->_ctx, d);
+    loop->enqueueMicrotask(0);
+
+    return 0;
+}
+
+}
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
 namespace duk {
 
 class DuktapeException: public std::runtime_error {
@@ -20,4 +24,22 @@ public:
         : DuktapeException(what) {}
 };
 
+/**
+ * Error thrown by a call of batch (see `FunctionHandle::callEach`), calls of
+ * the preceding elements have completed
+ */
+class BatchCallError: public ScriptEvaluationExcepton {
+public:
+    BatchCallError(std::size_t index, const std::string &what)
+        : ScriptEvaluationExcepton(what), _index(index) {}
+
+    /**
+     * Index of the failed element in the batch
+     */
+    std::size_t index() const { return _index; }
+
+private:
+    std::size_t _index;
+};
+
 }
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <string>
+
+#include <duktape.h>
+
+#include "Type.h"
+
+namespace duk {
+
+class Context;
+
+namespace details {
+
+/**
+ * Value kept as stashed reference (see `Context::stashRef`), heap values are pushed
+ * by heap pointer without looking the stash up
+ */
+class StashedValue {
+public:
+    StashedValue() = default;
+
+    /**
+     * Stash value at `index` of the current stack
+     */
+    StashedValue(Context &d, int index);
+
+    ~StashedValue();
+
+    StashedValue(StashedValue const &) = delete;
+    StashedValue & operator = (StashedValue const &) = delete;
+
+    StashedValue(StashedValue &&that) noexcept;
+    StashedValue & operator = (StashedValue &&that) noexcept;
+
+    /**
+     * Push value to the current stack of the context
+     */
+    void push(Context &d) const;
+
+    bool isValid() const { return _d != nullptr; }
+
+    duk_context * ptr() const { return _d; }
+
+private:
+    duk_context *_d = nullptr;
+    int _ref = -1;
+    void *_ptr = nullptr;
+
+    void release();
+};
+
+/**
+ * Global variable resolved once: its name and value are stashed, so using the value
+ * doesn't look up the global object
+ */
+class GlobalRef {
+public:
+    GlobalRef() = default;
+
+    /**
+     * Resolve global variable
+     * @throws KeyError if variable is undefined
+     */
+    GlobalRef(Context &d, const char *name);
+
+    /**
+     * Push resolved value to the current stack of the context
+     */
+    void push(Context &d) const { _value.push(d); }
+
+    bool isStale() const;
+    bool revalidate();
+
+    bool isValid() const { return _value.isValid(); }
+
+    std::string name() const;
+
+    duk_context * ptr() const { return _value.ptr(); }
+
+private:
+    StashedValue _name;
+    StashedValue _value;
+
+    void pushCurrent(Context &d) const;
+};
+
+}
+
+/**
+ * @brief Property name interned once per context
+ * @details Name string is kept in the heap stash and pushed by heap pointer, so property
+ *          access by key (see `JSObject`) doesn't hash the name. Key must not outlive its context.
+ */
+class PropertyKey {
+public:
+    PropertyKey() = default;
+
+    PropertyKey(Context &d, const char *name);
+
+    /**
+     * @brief Push key to the current stack of the context
+     */
+    void push(Context &d) const { _key.push(d); }
+
+    bool isValid() const { return _key.isValid(); }
+
+    duk_context * ptr() const { return _key.ptr(); }
+
+private:
+    details::StashedValue _key;
+};
+
+/**
+ * @brief Cached reference to a global variable
+ * @details Variable is looked up once, when handle is created, and its value is kept
+ *          in the heap stash, so `get` only converts the value. Script can reassign
+ *          the variable later: `isStale` checks it with a single property lookup,
+ *          `revalidate` resolves it again. Handle must not outlive its context.
+ *
+ * @code
+ * duk::GlobalHandle<std::shared_ptr<Game::Spaceship>> ship(ctx, "ship");
+ * auto s = ship.get();
+ * @endcode
+ */
+template <class T>
+class GlobalHandle {
+public:
+    GlobalHandle() = default;
+
+    /**
+     * @brief Resolve global variable
+     * @throws KeyError if variable is undefined
+     */
+    GlobalHandle(Context &d, const char *name) : _ref(d, name) {}
+
+    /**
+     * @brief Get value of the variable (as it was when handle was resolved)
+     */
+    void get(T &res) const;
+
+    T get() const;
+
+    /**
+     * @brief Check if script has assigned another value to the variable
+     */
+    bool isStale() const { return _ref.isStale(); }
+
+    /**
+     * @brief Resolve variable again if it's stale
+     * @returns true if the value has changed
+     * @throws KeyError if variable has become undefined
+     */
+    bool revalidate() { return _ref.revalidate(); }
+
+    bool isValid() const { return _ref.isValid(); }
+
+private:
+    details::GlobalRef _ref;
+};
+
+template <class F>
+class FunctionHandle;
+
+/**
+ * @brief Cached reference to a global javascript function
+ * @details Function is looked up once, calls push it by heap pointer and call it directly,
+ *          without `std::function` wrapping. If script reassigns the function, handle keeps
+ *          calling the previous one until `revalidate` is called.
+ *          Handle must not outlive its context.
+ *
+ * @code
+ * duk::FunctionHandle<void(double)> onTick(ctx, "onTick");
+ * for (...) {
+ *     onTick(dt);
+ * }
+ *
+ * duk::FunctionHandle<bool(Record)> filter(ctx, "filter");
+ * std::vector<bool> passed;
+ * filter.callEach(records.begin(), records.end(), std::back_inserter(passed));
+ * @endcode
+ */
+template <class R, class ... A>
+class FunctionHandle<R(A...)> {
+public:
+    FunctionHandle() = default;
+
+    /**
+     * @brief Resolve global function
+     * @throws KeyError if variable is undefined or is not a function
+     */
+    FunctionHandle(Context &d, const char *name);
+
+    /**
+     * @brief Call function
+     * @throws ScriptEvaluationExcepton if function throws an error
+     */
+    R operator () (A ... args) const;
+
+    /**
+     * @brief Call function for each element of range [first, last) and write results to `out`
+     * @details Elements are arguments of the calls, elements of functions taking several arguments
+     *          are tuples (unpacked with `std::get`). Context lookup, stack reservation and function
+     *          reference are shared by the whole batch, each element still gets its own protected call.
+     * @returns output iterator past the last result
+     * @throws BatchCallError with index of the failed element, results of the preceding
+     *         elements are already written
+     */
+    template <class InputIt, class OutputIt>
+    OutputIt callEach(InputIt first, InputIt last, OutputIt out) const;
+
+    /**
+     * @brief Call function for each element of range [first, last) ignoring results
+     * @see callEach
+     */
+    template <class InputIt>
+    void callEach(InputIt first, InputIt last) const;
+
+    /**
+     * @brief Check if script has assigned another value to the variable
+     */
+    bool isStale() const { return _ref.isStale(); }
+
+    /**
+     * @brief Resolve function again if it's stale
+     * @returns true if the function has changed
+     * @throws KeyError if variable has become undefined or is not a function
+     */
+    bool revalidate();
+
+    bool isValid() const { return _ref.isValid(); }
+
+private:
+    details::GlobalRef _ref;
+
+    void requireFunction() const;
+
+    template <class InputIt, class Sink>
+    void callBatch(InputIt first, InputIt last, Sink sink) const;
+};
+
+}
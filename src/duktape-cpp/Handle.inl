@@ -0,0 +1,272 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include "Handle.h"
+#include "Context.h"
+#include "Exceptions.h"
+#include "Tracer.h"
+
+#include "./Types/Function.h"
+#include "./Utils/Helpers.h"
+
+namespace duk {
+
+namespace details {
+
+inline StashedValue::StashedValue(Context &d, int index)
+    : _d(d.ptr()), _ref(d.stashRef(index)), _ptr(duk_get_heapptr(d, index)) {}
+
+inline StashedValue::~StashedValue() {
+    release();
+}
+
+inline StashedValue::StashedValue(StashedValue &&that) noexcept
+    : _d(that._d), _ref(that._ref), _ptr(that._ptr) {
+    that._d = nullptr;
+    that._ref = -1;
+    that._ptr = nullptr;
+}
+
+inline StashedValue & StashedValue::operator = (StashedValue &&that) noexcept {
+    if (this == &that) {
+        return *this;
+    }
+
+    release();
+
+    _d = that._d;
+    _ref = that._ref;
+    _ptr = that._ptr;
+
+    that._d = nullptr;
+    that._ref = -1;
+    that._ptr = nullptr;
+
+    return *this;
+}
+
+inline void StashedValue::push(Context &d) const {
+    assert(_d);
+
+    if (_ptr) {
+        duk_push_heapptr(d, _ptr);
+    }
+    else {
+        d.getRef(_ref);
+    }
+}
+
+inline void StashedValue::release() {
+    if (_d) {
+        Context &ctx = Context::GetSelfFromContext(_d);
+        ctx.unstashRef(_ref);
+        _d = nullptr;
+        _ref = -1;
+        _ptr = nullptr;
+    }
+}
+
+inline GlobalRef::GlobalRef(Context &d, const char *name) {
+    duk_push_string(d, name);
+    _name = StashedValue(d, -1);
+    duk_pop(d);
+
+    pushCurrent(d);
+    if (duk_is_undefined(d, -1)) {
+        duk_pop(d);
+        throw KeyError(std::string(name) + " is undefined");
+    }
+
+    _value = StashedValue(d, -1);
+    duk_pop(d);
+}
+
+inline bool GlobalRef::isStale() const {
+    assert(isValid());
+
+    Context &d = Context::GetSelfFromContext(ptr());
+    pushCurrent(d);
+    push(d);
+    bool stale = !duk_samevalue(d, -1, -2);
+    duk_pop_2(d);
+
+    return stale;
+}
+
+inline bool GlobalRef::revalidate() {
+    if (!isStale()) {
+        return false;
+    }
+
+    Context &d = Context::GetSelfFromContext(ptr());
+    pushCurrent(d);
+    if (duk_is_undefined(d, -1)) {
+        duk_pop(d);
+        throw KeyError(name() + " is undefined");
+    }
+
+    _value = StashedValue(d, -1);
+    duk_pop(d);
+
+    return true;
+}
+
+inline std::string GlobalRef::name() const {
+    Context &d = Context::GetSelfFromContext(_name.ptr());
+    _name.push(d);
+    std::string res = duk_get_string(d, -1);
+    duk_pop(d);
+
+    return res;
+}
+
+/**
+ * Push current value of the variable, name is pushed by heap pointer, so it isn't interned again
+ */
+inline void GlobalRef::pushCurrent(Context &d) const {
+    duk_push_global_object(d);
+    _name.push(d);
+    duk_get_prop(d, -2);
+    duk_remove(d, -2);
+}
+
+/**
+ * Pushes arguments of a batch call from range element (see `FunctionHandle::callEach`)
+ */
+template <class ... A>
+struct BatchArgs {
+    template <class E>
+    static void push(Context &d, E const &element) {
+        push(d, element, std::index_sequence_for<A...>{});
+    }
+
+    template <class E, std::size_t ... I>
+    static void push(Context &d, E const &element, std::index_sequence<I...>) {
+        PushArgs(d, static_cast<ClearType<A> const &>(std::get<I>(element))...);
+    }
+};
+
+template <class A>
+struct BatchArgs<A> {
+    template <class E>
+    static void push(Context &d, E const &element) {
+        Type<ClearType<A>>::push(d, static_cast<ClearType<A> const &>(element));
+    }
+};
+
+}
+
+inline PropertyKey::PropertyKey(Context &d, const char *name) {
+    duk_push_string(d, name);
+    _key = details::StashedValue(d, -1);
+    duk_pop(d);
+}
+
+template <class T>
+inline void GlobalHandle<T>::get(T &res) const {
+    Context &d = Context::GetSelfFromContext(_ref.ptr());
+    _ref.push(d);
+    Type<T>::get(d, res, -1);
+    duk_pop(d);
+}
+
+template <class T>
+inline T GlobalHandle<T>::get() const {
+    T res {};
+    get(res);
+    return res;
+}
+
+template <class R, class ... A>
+inline FunctionHandle<R(A...)>::FunctionHandle(Context &d, const char *name) : _ref(d, name) {
+    requireFunction();
+}
+
+template <class R, class ... A>
+inline R FunctionHandle<R(A...)>::operator () (A ... args) const {
+    Context &d = Context::GetSelfFromContext(_ref.ptr());
+    Context::ThreadScope scope(d, d.current());
+    details::TraceScope trace("FunctionHandle::call", "call");
+
+    _ref.push(d);
+    details::PushArgs(d, std::move(args)...);
+
+    duk_int_t callRes = duk_pcall(d, sizeof...(A));
+    scope.restore();
+
+    if (callRes != DUK_EXEC_SUCCESS) {
+        details::ThrowCallError(d);
+    }
+
+    return details::JSFunctionReturnVal<R>::get(d, 0);
+}
+
+template <class R, class ... A>
+template <class InputIt, class OutputIt>
+inline OutputIt FunctionHandle<R(A...)>::callEach(InputIt first, InputIt last, OutputIt out) const {
+    callBatch(first, last, [&out] (Context &d) {
+        *out = details::JSFunctionReturnVal<R>::get(d, 0);
+        ++out;
+    });
+    return out;
+}
+
+template <class R, class ... A>
+template <class InputIt>
+inline void FunctionHandle<R(A...)>::callEach(InputIt first, InputIt last) const {
+    callBatch(first, last, [] (Context &d) {
+        duk_pop(d);
+    });
+}
+
+template <class R, class ... A>
+template <class InputIt, class Sink>
+inline void FunctionHandle<R(A...)>::callBatch(InputIt first, InputIt last, Sink sink) const {
+    Context &d = Context::GetSelfFromContext(_ref.ptr());
+    Context::ThreadScope scope(d, d.current());
+    details::TraceScope trace("FunctionHandle::callEach", "call");
+
+    duk_require_stack(d, duk_idx_t(sizeof...(A)) + 1);
+
+    for (std::size_t index = 0; first != last; ++first, ++index) {
+        _ref.push(d);
+        details::BatchArgs<A...>::push(d, *first);
+
+        duk_int_t callRes = duk_pcall(d, sizeof...(A));
+        scope.restore();
+
+        if (callRes != DUK_EXEC_SUCCESS) {
+            throw BatchCallError(index, details::PopCallError(d));
+        }
+
+        sink(d);
+    }
+}
+
+template <class R, class ... A>
+inline bool FunctionHandle<R(A...)>::revalidate() {
+    bool changed = _ref.revalidate();
+    if (changed) {
+        requireFunction();
+    }
+    return changed;
+}
+
+template <class R, class ... A>
+inline void FunctionHandle<R(A...)>::requireFunction() const {
+    Context &d = Context::GetSelfFromContext(_ref.ptr());
+    _ref.push(d);
+    bool isFunction = duk_is_function(d, -1);
+    duk_pop(d);
+
+    if (!isFunction) {
+        throw KeyError(_ref.name() + " is not a function");
+    }
+}
+
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include <duktape.h>
+
+namespace duk {
+
+class Context;
+class EventLoop;
+
+namespace details {
+
+/**
+ * Hidden property keys used by bindings.
+ * Keys are interned once per context and pushed by heap pointer (see `PushHiddenKey`),
+ * so binding hot paths don't hash key strings.
+ */
+enum class HiddenKey {
+    ObjPtr,
+    SptrKey,
+    UptrKey,
+    MethodPtr,
+    FuncPtr,
+    StatsPtr,
+    TraceName,
+    Overloads,
+    Borrowed,
+    Parent,
+    Prototypes,
+    Deferred,
+    CoroSpawn,
+    CoroResume,
+    Count
+};
+
+inline const char * HiddenKeyName(HiddenKey key) {
+    static const char * const names[] = {
+        "\xff" "obj_ptr",
+        "\xff" "sptr_key",
+        "\xff" "uptr_key",
+        "\xff" "method_ptr",
+        "\xff" "func_ptr",
+        "\xff" "stats_ptr",
+        "\xff" "trace_name",
+        "\xff" "overloads",
+        "\xff" "borrowed",
+        "\xff" "parent",
+        "\xff" "prototypes",
+        "\xff" "deferred",
+        "\xff" "coro_spawn",
+        "\xff" "coro_resume"
+    };
+    static_assert(sizeof(names) / sizeof(names[0]) == std::size_t(HiddenKey::Count), "missing key name");
+
+    return names[std::size_t(key)];
+}
+
+/**
+ * Heap user data passed to duktape hooks
+ */
+struct HeapData {
+    /**
+     * Called from bytecode executor (see DUK_CPP_INTERRUPT_HOOK in duk_config.h), must be the first member
+     */
+    duk_bool_t (*interruptHook)(void *udata) = nullptr;
+
+    bool (*interruptHandler)(void *data) = nullptr;
+    void *interruptData = nullptr;
+
+    /**
+     * Garbage collection counters (see Context::collectGarbage)
+     */
+    std::size_t finalizersRun = 0;
+    std::size_t boxesReleased = 0;
+    int gcDeferCount = 0;
+
+    /**
+     * Context owning the heap
+     */
+    Context *self = nullptr;
+
+    /**
+     * Event loop bound to the context (see EventLoop::GetFromContext)
+     */
+    EventLoop *eventLoop = nullptr;
+
+    /**
+     * Heap pointers of interned hidden keys, strings are kept reachable from the global stash
+     */
+    void *keys[std::size_t(HiddenKey::Count)] = {};
+
+    /**
+     * Heap pointer of object holding stashed references (see Context::stashRef)
+     */
+    void *refs = nullptr;
+
+    /**
+     * Heap pointers of class prototypes indexed by `TypeSlot`, prototypes are kept reachable
+     * from `prototypeStore` array in the global stash (see `PushPrototype`)
+     */
+    std::vector<void*> prototypes;
+    void *prototypeStore = nullptr;
+};
+
+/**
+ * Process-wide index of type T, used to address per-context caches without hashing type names
+ */
+inline std::size_t NextTypeSlot() {
+    static std::atomic<std::size_t> counter { 0 };
+    return counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+template <class T>
+struct TypeSlot {
+    static std::size_t get() {
+        static const std::size_t slot = NextTypeSlot();
+        return slot;
+    }
+};
+
+inline HeapData & GetHeapData(duk_context *d) {
+    duk_memory_functions funcs;
+    duk_get_memory_functions(d, &funcs);
+    return *static_cast<HeapData*>(funcs.udata);
+}
+
+inline void PushHiddenKey(duk_context *d, HiddenKey key) {
+    duk_push_heapptr(d, GetHeapData(d).keys[std::size_t(key)]);
+}
+
+/**
+ * Same as `duk_get_prop_string` with hidden key
+ */
+inline duk_bool_t GetHiddenProp(duk_context *d, duk_idx_t objIdx, HiddenKey key) {
+    duk_idx_t idx = duk_normalize_index(d, objIdx);
+    PushHiddenKey(d, key);
+    return duk_get_prop(d, idx);
+}
+
+/**
+ * Same as `duk_put_prop_string` with hidden key
+ */
+inline duk_bool_t PutHiddenProp(duk_context *d, duk_idx_t objIdx, HiddenKey key) {
+    duk_idx_t idx = duk_normalize_index(d, objIdx);
+    PushHiddenKey(d, key);
+    duk_swap_top(d, -2);
+    return duk_put_prop(d, idx);
+}
+
+/**
+ * Same as `duk_has_prop_string` with hidden key
+ */
+inline duk_bool_t HasHiddenProp(duk_context *d, duk_idx_t objIdx, HiddenKey key) {
+    duk_idx_t idx = duk_normalize_index(d, objIdx);
+    PushHiddenKey(d, key);
+    return duk_has_prop(d, idx);
+}
+
+}}
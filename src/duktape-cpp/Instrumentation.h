@@ -0,0 +1,79 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include <duktape.h>
+
+#include "BindingStats.h"
+#include "Tracer.h"
+
+namespace duk { namespace details {
+
+/**
+ * Safe call body of `ProtectedNativeCall`, calls native function pointed by `udata`
+ * and leaves its return value on the stack top
+ */
+inline duk_ret_t ProtectedNativeCallBody(duk_context *d, void *udata) {
+    duk_c_function f = *static_cast<duk_c_function*>(udata);
+
+    duk_ret_t rc = f(d);
+    if (rc < 0) {
+        duk_error(d, -rc, "error (rc %ld)", static_cast<long>(rc));
+    }
+    if (rc == 0) {
+        duk_push_undefined(d);
+    }
+    return 1;
+}
+
+/**
+ * @brief Call native function `f` in a protected call on the stack of the running function
+ * @details Arguments of the running function are replaced by the return value of `f` or the error.
+ * @returns DUK_EXEC_SUCCESS or DUK_EXEC_ERROR
+ */
+inline duk_int_t ProtectedNativeCall(duk_context *d, duk_c_function f) {
+    return duk_safe_call(d, ProtectedNativeCallBody, &f, duk_get_top(d), 1);
+}
+
+/**
+ * @brief Call native binding `f` recording its duration to `stats` (see `BindingStats`)
+ *        and trace event `traceName` (see `Tracer`)
+ * @details Duktape errors longjmp past destructors, so the binding runs in a protected call,
+ *          the error is rethrown after the sample and the event are recorded.
+ *          Without stats and running tracer `f` is called directly.
+ */
+inline duk_ret_t InstrumentedCall(duk_context *d, duk_c_function f, BindingStatsRecord *stats,
+                                  const char *traceName, const char *category) {
+#if defined(DUK_CPP_BINDING_STATS) || defined(DUK_CPP_TRACING)
+    bool traced = Tracer::IsEnabled() && Tracer::IsRunning();
+    if (stats || traced) {
+        std::int64_t traceStart = traced ? Tracer::Now() : 0;
+#if defined(DUK_CPP_BINDING_STATS)
+        auto start = std::chrono::steady_clock::now();
+        duk_int_t rc = ProtectedNativeCall(d, f);
+        if (stats) {
+            stats->record(std::chrono::steady_clock::now() - start);
+        }
+#else
+        duk_int_t rc = ProtectedNativeCall(d, f);
+#endif
+
+        if (traced) {
+            Tracer::Complete(traceName, category, traceStart);
+        }
+
+        if (rc != DUK_EXEC_SUCCESS) {
+            duk_throw(d);
+        }
+        return 1;
+    }
+#else
+    (void) stats;
+    (void) traceName;
+    (void) category;
+#endif
+    return f(d);
+}
+
+}}
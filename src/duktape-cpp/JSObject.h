@@ -0,0 +1,90 @@
+#pragma once
+
+#include <duktape.h>
+
+#include "Handle.h"
+#include "Type.h"
+
+namespace duk {
+
+class Context;
+
+/**
+ * @brief Handle to a javascript object
+ * @details Object is kept as stashed reference, so it stays alive while the handle exists.
+ *          Properties are accessed by `PropertyKey`, so repeated calls of script methods
+ *          (e.g. of plugin instances) don't intern names or wrap functions into `std::function`.
+ *          Handle can be obtained from the stack like other values (`evalString`, `getGlobal`,
+ *          arguments of bound methods) and must not outlive its context.
+ *
+ * @code
+ * duk::JSObject plugin;
+ * ctx.evalString(plugin, "new Plugin()");
+ * duk::PropertyKey update(ctx, "update");
+ * plugin.call<void>(update, dt);
+ * @endcode
+ */
+class JSObject {
+public:
+    JSObject() = default;
+
+    /**
+     * @brief Reference object at `index` of the current stack (throws script TypeError if it isn't object)
+     */
+    JSObject(Context &d, int index);
+
+    /**
+     * @brief Call method `key` of the object
+     * @throws ScriptEvaluationExcepton if method throws an error or is not callable
+     */
+    template <class R, class ... A>
+    R call(PropertyKey const &key, A && ... args) const;
+
+    /**
+     * @brief Get property value
+     * @throws KeyError if property is undefined
+     * @throws ScriptEvaluationExcepton if getter throws an error or value has wrong type
+     */
+    template <class T>
+    void get(PropertyKey const &key, T &res) const;
+
+    template <class T>
+    T get(PropertyKey const &key) const;
+
+    /**
+     * @brief Set property value
+     * @throws ScriptEvaluationExcepton if setter throws an error or property is not writable
+     */
+    template <class T>
+    void set(PropertyKey const &key, T &&value) const;
+
+    /**
+     * @brief Check if object (or its prototype chain) has property
+     * @throws ScriptEvaluationExcepton if Proxy trap throws an error
+     */
+    bool has(PropertyKey const &key) const;
+
+    /**
+     * @brief Push object to the current stack of the context
+     */
+    void push(Context &d) const { _obj.push(d); }
+
+    bool isValid() const { return _obj.isValid(); }
+
+private:
+    details::StashedValue _obj;
+
+    Context & context() const;
+    void pushWithKey(Context &d, PropertyKey const &key) const;
+};
+
+template <>
+struct Type<JSObject> {
+    static void push(duk::Context &d, JSObject const &val);
+
+    static void get(duk::Context &d, JSObject &val, int index);
+
+    static constexpr bool isPrimitive() { return true; };
+};
+
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cassert>
+#include <string>
+#include <utility>
+
+#include "JSObject.h"
+#include "Handle.inl"
+#include "Context.h"
+#include "Exceptions.h"
+#include "Tracer.h"
+
+#include "./Types/Function.h"
+#include "./Utils/Helpers.h"
+
+namespace duk {
+
+namespace details {
+
+/**
+ * Run property access on `nargs` values at the stack top (object, key and value) with `duk_safe_call`,
+ * so that errors of getters, setters and Proxy traps don't reach the fatal handler
+ * @throws ScriptEvaluationExcepton if access throws an error
+ */
+inline void SafePropertyAccess(Context &d, duk_safe_call_function func, void *udata, duk_idx_t nargs) {
+    Context::ThreadScope scope(d, d.current());
+    duk_int_t callRes = duk_safe_call(d, func, udata, nargs, 1);
+    scope.restore();
+
+    if (callRes != DUK_EXEC_SUCCESS) {
+        throw ScriptEvaluationExcepton(PopCallError(d));
+    }
+
+    duk_pop(d);
+}
+
+template <class T>
+struct PropertyRead {
+    T &res;
+    bool defined;
+
+    static duk_ret_t run(duk_context *d, void *udata) {
+        PropertyRead &self = *static_cast<PropertyRead*>(udata);
+
+        duk_get_prop(d, 0);
+        self.defined = !duk_is_undefined(d, 1);
+        if (self.defined) {
+            Type<T>::get(Context::GetSelfFromContext(d), self.res, 1);
+        }
+
+        return 0;
+    }
+};
+
+inline duk_ret_t PropertyWrite(duk_context *d, void *) {
+    duk_put_prop(d, 0);
+    return 0;
+}
+
+inline duk_ret_t PropertyHas(duk_context *d, void *udata) {
+    *static_cast<bool*>(udata) = duk_has_prop(d, 0) != 0;
+    return 0;
+}
+
+}
+
+inline JSObject::JSObject(Context &d, int index) {
+    duk_require_type_mask(d, index, DUK_TYPE_MASK_OBJECT);
+    _obj = details::StashedValue(d, index);
+}
+
+inline Context & JSObject::context() const {
+    assert(isValid());
+    return Context::GetSelfFromContext(_obj.ptr());
+}
+
+inline void JSObject::pushWithKey(Context &d, PropertyKey const &key) const {
+    assert(key.ptr() == _obj.ptr() && "key belongs to another context");
+
+    _obj.push(d);
+    key.push(d);
+}
+
+template <class R, class ... A>
+inline R JSObject::call(PropertyKey const &key, A && ... args) const {
+    Context &d = context();
+    Context::ThreadScope scope(d, d.current());
+    details::TraceScope trace("JSObject::call", "call");
+
+    pushWithKey(d, key);
+    details::PushArgs(d, std::forward<A>(args)...);
+
+    duk_int_t callRes = duk_pcall_prop(d, -duk_idx_t(sizeof...(A)) - 2, sizeof...(A));
+    scope.restore();
+
+    if (callRes != DUK_EXEC_SUCCESS) {
+        std::string error = details::PopCallError(d);
+        duk_pop(d);
+        throw ScriptEvaluationExcepton(error);
+    }
+
+    return details::JSFunctionReturnVal<R>::get(d, 1);
+}
+
+template <class T>
+inline void JSObject::get(PropertyKey const &key, T &res) const {
+    Context &d = context();
+    pushWithKey(d, key);
+
+    details::PropertyRead<T> read { res, false };
+    details::SafePropertyAccess(d, &details::PropertyRead<T>::run, &read, 2);
+
+    if (!read.defined) {
+        key.push(d);
+        std::string name = duk_safe_to_string(d, -1);
+        duk_pop(d);
+        throw KeyError(name + " is undefined");
+    }
+}
+
+template <class T>
+inline T JSObject::get(PropertyKey const &key) const {
+    T res {};
+    get(key, res);
+    return res;
+}
+
+template <class T>
+inline void JSObject::set(PropertyKey const &key, T &&value) const {
+    Context &d = context();
+    pushWithKey(d, key);
+    Type<ClearType<T>>::push(d, std::forward<T>(value));
+    details::SafePropertyAccess(d, &details::PropertyWrite, nullptr, 3);
+}
+
+inline bool JSObject::has(PropertyKey const &key) const {
+    Context &d = context();
+    pushWithKey(d, key);
+
+    bool res = false;
+    details::SafePropertyAccess(d, &details::PropertyHas, &res, 2);
+    return res;
+}
+
+inline void Type<JSObject>::push(duk::Context &d, JSObject const &val) {
+    val.push(d);
+}
+
+inline void Type<JSObject>::get(duk::Context &d, JSObject &val, int index) {
+    val = JSObject(d, index);
+}
+
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include <duktape.h>
+
+#include "./Utils/ClassInfo.h"
+#include "./Utils/Inspect.h"
+
+#include "Context.h"
+#include "EmptyInspector.h"
+#include "PushObjectInspector.h"
+#include "NativeObject.h"
+#include "BindingStats.h"
+#include "Instrumentation.h"
+#include "Tracer.h"
+#include "Method.h"
+
+namespace duk { namespace details {
+
+/**
+ * Binding of a class called through its `LightFuncTable`
+ */
+struct LightFuncEntry {
+    static constexpr std::size_t MaxMethodSize = 4 * sizeof(void*);
+
+    duk_ret_t (*call)(duk_context *d, LightFuncEntry const &entry);
+    BindingStatsRecord *stats;
+    const char *traceName;
+    duk_idx_t nargs;
+    alignas(std::max_align_t) unsigned char method[MaxMethodSize];
+};
+
+template <class M, class C, class R, class ... A>
+struct LightMethod {
+    static_assert(sizeof(M) <= LightFuncEntry::MaxMethodSize, "method pointer doesn't fit into table entry");
+
+    static LightFuncEntry entry(M method, const char *prefix, const char *name) {
+        LightFuncEntry e;
+        e.call = call;
+        e.stats = FindBindingStats(ClassName<C>::value, prefix, name);
+        e.traceName = TraceName(ClassName<C>::value, prefix, name);
+        e.nargs = duk_idx_t(sizeof...(A));
+        std::memcpy(e.method, &method, sizeof(M));
+        return e;
+    }
+
+    static duk_ret_t call(duk_context *d, LightFuncEntry const &e) {
+        Context &ctx = Context::GetSelfFromContext(d);
+        Context::ThreadScope scope(ctx, d);
+
+        duk_push_this(d);
+        C *objPtr = NativeObjectGetter<C, UncheckedCalls<C>::value>::get(d, -1);
+        duk_pop(d);
+
+        M method;
+        std::memcpy(&method, e.method, sizeof(M));
+
+        MethodDispatcher<C, R, A...> m;
+        return m.dispatch(std::mem_fn(method), objPtr, ctx);
+    }
+};
+
+/**
+ * Collects lightfunc bindings of a class in inspection order
+ */
+class LightFuncTableBuilder: public EmptyInspector {
+public:
+    using EmptyInspector::property;
+    using EmptyInspector::method;
+
+    template <class C, class A>
+    void property(const char *name, Getter<C, A> getter, Setter<C, A> setter) {
+        entries.push_back(LightMethod<Getter<C, A>, C, A>::entry(getter, "get ", name));
+        entries.push_back(LightMethod<Setter<C, A>, C, void, A>::entry(setter, "set ", name));
+    }
+
+    template <class C, class A>
+    void property(const char *name, Getter<C, A> getter) {
+        entries.push_back(LightMethod<Getter<C, A>, C, A>::entry(getter, "get ", name));
+    }
+
+    template <class C, class R, class ... A>
+    void method(const char *name, R(C::*method)(A...)) {
+        entries.push_back(LightMethod<R(C::*)(A...), C, R, A...>::entry(method, "", name));
+    }
+
+    template <class C, class R, class ... A>
+    void method(const char *name, R(C::*method)(A...) const) {
+        entries.push_back(LightMethod<R(C::*)(A...) const, C, R, A...>::entry(method, "", name));
+    }
+
+    std::vector<LightFuncEntry> entries;
+};
+
+/**
+ * Table of lightfunc bindings of class T, built once per process.
+ * Binding is selected by the magic of the called function: lightfuncs have 8-bit magic,
+ * so the first 256 bindings are lightfuncs and further ones are plain native functions
+ * (still without hidden properties and finalizers).
+ */
+template <class T>
+class LightFuncTable {
+public:
+    static constexpr int MagicBias = 128;
+    static constexpr duk_idx_t MaxLightFuncArgs = 14;
+
+    static std::vector<LightFuncEntry> const & entries() {
+        static const std::vector<LightFuncEntry> table = build();
+        return table;
+    }
+
+    /**
+     * Push function calling binding at `index` of the table
+     */
+    static void push(duk_context *d, std::size_t index) {
+        assert(index < entries().size());
+
+        duk_idx_t nargs = entries()[index].nargs;
+        duk_int_t magic = duk_int_t(index) - MagicBias;
+
+        if (magic < MagicBias) {
+            duk_push_c_lightfunc(d, trampoline,
+                                 nargs <= MaxLightFuncArgs ? nargs : DUK_VARARGS,
+                                 nargs <= MaxLightFuncArgs + 1 ? nargs : MaxLightFuncArgs + 1,
+                                 magic);
+        }
+        else {
+            duk_push_c_function(d, trampoline, nargs);
+            duk_set_magic(d, -1, magic);
+        }
+    }
+
+    static duk_ret_t trampoline(duk_context *d) {
+        LightFuncEntry const &e = current(d);
+        if (e.nargs > MaxLightFuncArgs) {
+            duk_set_top(d, e.nargs);
+        }
+        return InstrumentedCall(d, call, e.stats, e.traceName, "method");
+    }
+
+private:
+    static LightFuncEntry const & current(duk_context *d) {
+        return entries()[std::size_t(duk_get_current_magic(d) + MagicBias)];
+    }
+
+    static duk_ret_t call(duk_context *d) {
+        LightFuncEntry const &e = current(d);
+        return e.call(d, e);
+    }
+
+    static std::vector<LightFuncEntry> build() {
+        LightFuncTableBuilder builder;
+        InspectOwn<T>::inspect(builder);
+        return std::move(builder.entries);
+    }
+};
+
+/**
+ * Pushes prototype members of T, methods and accessors are taken from `LightFuncTable`
+ * (inspection visits them in the same order as the table was built)
+ */
+template <class T>
+class PushLightFuncInspector: public PushObjectInspector {
+public:
+    PushLightFuncInspector(duk::Context &d, int objIdx): PushObjectInspector(d, objIdx) {}
+
+    using PushObjectInspector::property;
+    using PushObjectInspector::method;
+
+    template <class C, class A>
+    void property(const char *name, Getter<C, A> getter, Setter<C, A> setter) {
+        duk_push_string(_d, name);
+        pushNext();
+        pushNext();
+        duk_def_prop(_d, _objIdx, DUK_DEFPROP_HAVE_GETTER | DUK_DEFPROP_HAVE_SETTER);
+    }
+
+    template <class C, class A>
+    void property(const char *name, Getter<C, A> getter) {
+        duk_push_string(_d, name);
+        pushNext();
+        duk_def_prop(_d, _objIdx, DUK_DEFPROP_HAVE_GETTER);
+    }
+
+    template <class C, class R, class ... A>
+    void method(const char *name, R(C::*method)(A...)) {
+        pushNext();
+        duk_put_prop_string(_d, _objIdx, name);
+    }
+
+    template <class C, class R, class ... A>
+    void method(const char *name, R(C::*method)(A...) const) {
+        pushNext();
+        duk_put_prop_string(_d, _objIdx, name);
+    }
+
+private:
+    void pushNext() {
+        LightFuncTable<T>::push(_d, _next);
+        ++_next;
+    }
+
+    std::size_t _next = 0;
+};
+
+template <class T, bool Light = UsesLightFuncs<T>::value()>
+struct PrototypeInspector {
+    typedef PushObjectInspector type;
+};
+
+template <class T>
+struct PrototypeInspector<T, true> {
+    typedef PushLightFuncInspector<T> type;
+};
+
+}}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+namespace duk { namespace details {
+
+/**
+ * Process-wide append-only table of bound members (method and function pointers, constants).
+ * Native functions keep index of their entry as magic, so replaying a binding plan
+ * (see `ClassPlan`) creates a single function object without hidden properties and finalizer.
+ * Entries are stored in chunks which are never moved, so they are read without locking.
+ */
+template <class E>
+class MagicTable {
+public:
+    static constexpr int ChunkSize = 256;
+
+    /**
+     * Duktape keeps magic as 16-bit signed integer
+     */
+    static constexpr int Capacity = 32768;
+
+    /**
+     * @returns index of the entry or -1 if table is full
+     */
+    static int add(E const &entry) {
+        static std::mutex mutex;
+        std::lock_guard<std::mutex> lock(mutex);
+
+        int index = size();
+        if (index == Capacity) {
+            return -1;
+        }
+
+        std::atomic<E*> &chunk = chunks()[index / ChunkSize];
+        if (!chunk.load(std::memory_order_relaxed)) {
+            chunk.store(new E[ChunkSize], std::memory_order_release);
+        }
+
+        chunk.load(std::memory_order_relaxed)[index % ChunkSize] = entry;
+        size() += 1;
+        return index;
+    }
+
+    static E const & get(int index) {
+        return chunks()[index / ChunkSize].load(std::memory_order_acquire)[index % ChunkSize];
+    }
+
+private:
+    static std::atomic<E*> * chunks() {
+        static std::atomic<E*> table[Capacity / ChunkSize] {};
+        return table;
+    }
+
+    static int & size() {
+        static int n = 0;
+        return n;
+    }
+};
+
+}}
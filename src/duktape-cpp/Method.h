@@ -1,67 +1,132 @@
 #pragma once
 
 #include <functional>
+#include <future>
+#include <mutex>
+#include <type_traits>
 #include <unordered_map>
 
 #include <duktape.h>
 
 #include "./Utils/Helpers.h"
+#include "./Utils/ClassInfo.h"
 
 #include "Context.h"
+#include "NativeObject.h"
+#include "BindingStats.h"
+#include "Instrumentation.h"
+#include "MagicTable.h"
+#include "Tracer.h"
 
 #include "Type.h"
 
 namespace duk { namespace details {
 
-template <class A, int Index, bool IsPrimitive>
+/**
+ * Reads argument at `Index`, without type checks if `Unchecked` (see `UncheckedCalls`)
+ */
+template <class A, int Index, bool IsPrimitive, bool Unchecked = false>
 struct ArgGetter {
     static A get(duk::Context &d);
 };
 
-template <class A, int Index>
-struct ArgGetter<A, Index, true> {
+template <class A, int Index, bool Unchecked>
+struct ArgGetter<A, Index, true, Unchecked> {
+    typedef typename std::conditional<Unchecked, UncheckedType<ClearType<A>>, Type<ClearType<A>>>::type Conv;
+
     static ClearType<A> get(duk::Context &d) {
         ClearType<A> instance;
-        Type<ClearType<A>>::get(d, instance, Index);
+        Conv::get(d, instance, Index);
         return instance;
     }
 };
 
 // object passed by value is copied
-template <class A, int Index>
-struct ArgGetter<A, Index, false> {
+template <class A, int Index, bool Unchecked>
+struct ArgGetter<A, Index, false, Unchecked> {
     static ClearType<A> get(duk::Context &d) {
-        return ArgGetter<A, Index, true>::get(d);
+        return ArgGetter<A, Index, true, Unchecked>::get(d);
     }
 };
 
 // reference to primitive type
-template <class A, int Index>
-struct ArgGetter<A const &, Index, true> {
+template <class A, int Index, bool Unchecked>
+struct ArgGetter<A const &, Index, true, Unchecked> {
     static A get(duk::Context &d) {
         // primitive types are copied from context
-        return ArgGetter<ClearType<A>, Index, true>::get(d);
+        return ArgGetter<ClearType<A>, Index, true, Unchecked>::get(d);
     }
 };
 
 // reference to object
-template <class A, int Index>
-struct ArgGetter<A&, Index, false> {
+template <class A, int Index, bool Unchecked>
+struct ArgGetter<A&, Index, false, Unchecked> {
     static A& get(duk::Context &d) {
-        if (!duk_has_prop_string(d, Index, "\xff" "obj_ptr")) {
-            duk_error(d, DUK_ERR_TYPE_ERROR, "Expected reference to object, but `obj_ptr` not defined");
-        }
-        duk_get_prop_string(d, Index, "\xff" "obj_ptr");
-        A *obj = reinterpret_cast<A*>(duk_get_pointer(d, -1));
-        duk_pop(d);
-        return *obj;
+        return *NativeObjectGetter<A, Unchecked>::get(d, Index);
     }
 };
 
-template <class A, int Index>
-struct ArgGetter<A const &, Index, false> {
+template <class A, int Index, bool Unchecked>
+struct ArgGetter<A const &, Index, false, Unchecked> {
     static A const & get(duk::Context &d) {
-        return ArgGetter<A&, Index, false>::get(d);
+        return ArgGetter<A&, Index, false, Unchecked>::get(d);
+    }
+};
+
+enum class ResultKind {
+    Converted,  ///< type with `Type` specialization
+    Value,      ///< object returned by value
+    Reference,  ///< reference to object
+    Pointer     ///< pointer to object
+};
+
+template <class R>
+struct ResultKindOf {
+    typedef typename std::remove_cv<typename std::remove_reference<R>::type>::type T;
+    typedef typename std::remove_cv<typename std::remove_pointer<T>::type>::type P;
+
+    template <class X>
+    static constexpr bool isObject() { return std::is_class<X>::value && !Type<X>::isPrimitive(); }
+
+    static constexpr ResultKind value =
+        std::is_pointer<T>::value ? (isObject<P>() ? ResultKind::Pointer : ResultKind::Converted) :
+        !isObject<T>() ? ResultKind::Converted :
+        std::is_reference<R>::value ? ResultKind::Reference : ResultKind::Value;
+};
+
+/**
+ * Pushes method result. Objects returned by value (types without `Type` specialization)
+ * are moved into storage owned by javascript, references and pointers to objects
+ * are pushed as wrappers of the original object tied to the lifetime of the parent wrapper.
+ */
+template <class R, ResultKind Kind = ResultKindOf<R>::value>
+struct ResultPusher {
+    template <class V>
+    static void push(duk::Context &d, V &&res) {
+        Type<ClearType<R>>::push(d, std::forward<V>(res));
+    }
+};
+
+template <class R>
+struct ResultPusher<R, ResultKind::Value> {
+    template <class V>
+    static void push(duk::Context &d, V &&res) {
+        PushValueObject(d, std::forward<V>(res));
+    }
+};
+
+template <class R>
+struct ResultPusher<R, ResultKind::Reference> {
+    template <class V>
+    static void push(duk::Context &d, V &&res) {
+        PushReferenceObject(d, &res);
+    }
+};
+
+template <class R>
+struct ResultPusher<R, ResultKind::Pointer> {
+    static void push(duk::Context &d, R res) {
+        PushReferenceObject(d, res);
     }
 };
 
@@ -70,34 +135,37 @@ struct ArgGetter<A const &, Index, false> {
  */
 template <class C, class R, class ... A>
 struct MethodDispatcher {
-    duk_ret_t dispatch(std::function<R(C*, A...)> const &func, C* obj, duk::Context &d) {
+    template <class F>
+    duk_ret_t dispatch(F const &func, C* obj, duk::Context &d) {
         R res = call(func, obj, d, std::index_sequence_for<A...>{});
-        Type<ClearType<R>>::push(d, std::move(res));
+        ResultPusher<R>::push(d, std::move(res));
         return 1;
     }
 
-    template<std::size_t ... I>
-    R call(std::function<R(C*, A...)> const &func, C* obj, duk::Context &d, std::index_sequence<I...>) {
-        return func(obj, ArgGetter<A, I, Type<ClearType<A>>::isPrimitive()>::get(d)...);
+    template<class F, std::size_t ... I>
+    R call(F const &func, C* obj, duk::Context &d, std::index_sequence<I...>) {
+        return func(obj, ArgGetter<A, I, Type<ClearType<A>>::isPrimitive(), UncheckedCalls<C>::value>::get(d)...);
     }
 };
 
 template <class C, class ... A>
 struct MethodDispatcher<C, void, A...> {
-    duk_ret_t dispatch(std::function<void(C*, A...)> const &func, C* obj, duk::Context &d) {
+    template <class F>
+    duk_ret_t dispatch(F const &func, C* obj, duk::Context &d) {
         call(func, obj, d, std::index_sequence_for<A...>{});
         return 0;
     }
 
-    template<std::size_t ...I>
-    void call(std::function<void(C*, A...)> const &func, C* obj, duk::Context &d, std::index_sequence<I...>) {
-        func(obj, ArgGetter<A, I, Type<ClearType<A>>::isPrimitive()>::get(d)...);
+    template<class F, std::size_t ...I>
+    void call(F const &func, C* obj, duk::Context &d, std::index_sequence<I...>) {
+        func(obj, ArgGetter<A, I, Type<ClearType<A>>::isPrimitive(), UncheckedCalls<C>::value>::get(d)...);
     }
 };
 
 template <class C>
 struct MethodDispatcher<C, void> {
-    duk_ret_t dispatch(std::function<void(C*)> const &func, C* obj, duk::Context &d) {
+    template <class F>
+    duk_ret_t dispatch(F const &func, C* obj, duk::Context &d) {
         func(obj);
         return 0;
     }
@@ -105,13 +173,58 @@ struct MethodDispatcher<C, void> {
 
 template <class C, class R>
 struct MethodDispatcher<C, R> {
-    duk_ret_t dispatch(std::function<R(C*)> const &func, C* obj, duk::Context &d) {
+    template <class F>
+    duk_ret_t dispatch(F const &func, C* obj, duk::Context &d) {
         R res = func(obj);
-        Type<ClearType<R>>::push(d, res);
+        ResultPusher<R>::push(d, std::move(res));
         return 1;
     }
 };
 
+/**
+ * Process-wide append-only table of methods of trusted classes (see `UncheckedCalls`).
+ * Functions calling them keep index in the table as magic, so calls don't look up
+ * the hidden `method_ptr` property and functions need no finalizer.
+ */
+template <class M>
+struct TrustedMethodTable {
+    static constexpr int Capacity = 64;
+
+    /**
+     * @returns index of the method or -1 if table is full
+     */
+    static int add(M method) {
+        static std::mutex mutex;
+        std::lock_guard<std::mutex> lock(mutex);
+
+        for (int i = 0; i < size(); ++i) {
+            if (entries()[i] == method) {
+                return i;
+            }
+        }
+
+        if (size() == Capacity) {
+            return -1;
+        }
+
+        entries()[size()] = method;
+        return size()++;
+    }
+
+    static M get(int index) { return entries()[index]; }
+
+private:
+    static M * entries() {
+        static M table[Capacity];
+        return table;
+    }
+
+    static int & size() {
+        static int n = 0;
+        return n;
+    }
+};
+
 /**
  * Push method into duktape stack
  * Stores pointer to method as hidden `method_ptr` field
@@ -133,7 +246,7 @@ struct Method {
 
         // Add hidden pointer to method holder
         duk_push_pointer(d, mh);
-        duk_put_prop_string(d, fidx, "\xff" "method_ptr");
+        details::PutHiddenProp(d, fidx, details::HiddenKey::MethodPtr);
 
         duk_push_c_function(d, funcFinalizer, 1);
         duk_set_finalizer(d, fidx);
@@ -147,21 +260,25 @@ struct Method {
      * stack and makes actual calls to methods.
      */
     static duk_ret_t func(duk_context *d) {
+        // Record call stats and trace (no-op unless built with DUK_CPP_BINDING_STATS or DUK_CPP_TRACING)
+        return InstrumentedCall(d, call, CurrentBindingStats(d), CurrentTraceName(d, ClassName<C>::value), "method");
+    }
+
+    static duk_ret_t call(duk_context *d) {
         // Get pointer to context
-        duk_push_global_stash(d);
-        duk_get_prop_string(d, -1, "self_ptr");
-        Context * dd = reinterpret_cast<Context*>(duk_get_pointer(d, -1));
-        duk_pop_2(d);
+        Context *dd = &Context::GetSelfFromContext(d);
+
+        // Bindings must work on the stack of the calling thread
+        Context::ThreadScope scope(*dd, d);
 
         // Get pointer to object
         duk_push_this(d);
-        duk_get_prop_string(d, -1, "\xff" "obj_ptr");
-        C * objPtr = reinterpret_cast<C*>(duk_get_pointer(d, -1));
-        duk_pop_2(d);
+        C * objPtr = NativeObjectGetter<C, UncheckedCalls<C>::value>::get(d, -1);
+        duk_pop(d);
 
         // Get pointer to method holder
         duk_push_current_function(d);
-        duk_get_prop_string(d, -1, "\xff" "method_ptr");
+        details::GetHiddenProp(d, -1, details::HiddenKey::MethodPtr);
         MethodPointer * mh = reinterpret_cast<MethodPointer*>(duk_get_pointer(d, -1));
         duk_pop_2(d);
 
@@ -170,9 +287,51 @@ struct Method {
         return m.dispatch(*mh, objPtr, *dd);
     }
 
+    /**
+     * Push member function, methods of trusted classes are kept in `TrustedMethodTable`
+     * (falls back to `pushMethod` when the table is full)
+     */
+    template <class M>
+    static int pushMember(duk::Context &d, M method) {
+        int index = UncheckedCalls<C>::value ? TrustedMethodTable<M>::add(method) : -1;
+        if (index < 0) {
+            return pushMethod(d, method);
+        }
+
+        auto fidx = duk_push_c_function(d, tableFunc<M, TrustedMethodTable<M>>, sizeof...(A));
+        duk_set_magic(d, fidx, index);
+        return fidx;
+    }
+
+    /**
+     * Same as `func` for methods kept in process-wide `Table` (`TrustedMethodTable` or `MagicTable`),
+     * index of the method is the magic of the function
+     */
+    template <class M, class Table>
+    static duk_ret_t tableFunc(duk_context *d) {
+        return InstrumentedCall(d, tableCall<M, Table>, CurrentBindingStats(d),
+                                CurrentTraceName(d, ClassName<C>::value), "method");
+    }
+
+    template <class M, class Table>
+    static duk_ret_t tableCall(duk_context *d) {
+        Context *dd = &Context::GetSelfFromContext(d);
+        Context::ThreadScope scope(*dd, d);
+
+        duk_push_this(d);
+        C * objPtr = NativeObjectGetter<C, UncheckedCalls<C>::value>::get(d, -1);
+        duk_pop(d);
+
+        MethodDispatcher<C, R, A...> m;
+        return m.dispatch(std::mem_fn(Table::get(duk_get_current_magic(d))), objPtr, *dd);
+    }
+
     static duk_ret_t funcFinalizer(duk_context *d) {
+        TraceScope trace(ClassName<C>::value, "finalizer");
+        Context::CountFinalizer(d);
+
         // object being finalized is at index 0
-        duk_get_prop_string(d, 0, "\xff" "method_ptr");
+        details::GetHiddenProp(d, 0, details::HiddenKey::MethodPtr);
         void * methodPtr = duk_get_pointer(d, -1);
         duk_pop(d);
 
@@ -183,14 +342,81 @@ struct Method {
     }
 };
 
+/**
+ * Push free (static) function into duktape stack
+ * Stores pointer to function as hidden `func_ptr` field
+ */
+template <class R, class ... A>
+struct StaticFunction {
+    typedef R (*TFunc)(A...);
+
+    static int push(duk::Context &d, TFunc f) {
+        auto fidx = duk_push_c_function(d, func, sizeof...(A));
+        duk_push_pointer(d, (void*)f);
+        details::PutHiddenProp(d, fidx, details::HiddenKey::FuncPtr);
+        return fidx;
+    }
+
+    static duk_ret_t func(duk_context *d) {
+        return InstrumentedCall(d, call, CurrentBindingStats(d), CurrentTraceName(d, "static method"), "method");
+    }
+
+    /**
+     * Same as `func` for functions kept in `MagicTable`, index of the function is the magic
+     */
+    static duk_ret_t tableFunc(duk_context *d) {
+        return InstrumentedCall(d, tableCall, CurrentBindingStats(d), CurrentTraceName(d, "static method"), "method");
+    }
+
+    static duk_ret_t call(duk_context *d) {
+        duk_push_current_function(d);
+        details::GetHiddenProp(d, -1, details::HiddenKey::FuncPtr);
+        TFunc f = reinterpret_cast<TFunc>(duk_get_pointer(d, -1));
+        duk_pop_2(d);
+
+        return dispatch(d, f);
+    }
+
+    static duk_ret_t tableCall(duk_context *d) {
+        return dispatch(d, MagicTable<TFunc>::get(duk_get_current_magic(d)));
+    }
+
+    static duk_ret_t dispatch(duk_context *d, TFunc f) {
+        Context &ctx = Context::GetSelfFromContext(d);
+        Context::ThreadScope scope(ctx, d);
+
+        MethodDispatcher<void, R, A...> m;
+        return m.dispatch([f] (void *, A ... args) -> R { return f(std::forward<A>(args)...); }, nullptr, ctx);
+    }
+};
+
 template <class C, class R, class ... A>
 void PushMethod(duk::Context &d, R (C::*method)(A...)) {
-    Method<C, R, A...>::pushMethod(d, method);
+    Method<C, R, A...>::pushMember(d, method);
 }
 
 template <class C, class R, class ... A>
 void PushMethod(duk::Context &d, R (C::*method)(A...) const) {
-    Method<C, R, A...>::pushMethod(d, method);
+    Method<C, R, A...>::pushMember(d, method);
+}
+
+/**
+ * Push method which runs on the thread pool of context's event loop.
+ * Arguments are copied, script receives thenable resolved with the result.
+ * Wrapper of the object is kept alive until the result is settled (see `Type<std::packaged_task>`).
+ */
+template <class C, class R, class ... A>
+void PushAsyncMethod(duk::Context &d, R (C::*method)(A...)) {
+    Method<C, std::packaged_task<R()>, A...>::pushMethod(d, [method] (C *obj, A ... args) {
+        return std::packaged_task<R()>(std::bind(method, obj, ClearType<A>(args)...));
+    });
+}
+
+template <class C, class R, class ... A>
+void PushAsyncMethod(duk::Context &d, R (C::*method)(A...) const) {
+    Method<C, std::packaged_task<R()>, A...>::pushMethod(d, [method] (C *obj, A ... args) {
+        return std::packaged_task<R()>(std::bind(method, obj, ClearType<A>(args)...));
+    });
 }
 
 }}
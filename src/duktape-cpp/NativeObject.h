@@ -0,0 +1,227 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#include <duktape.h>
+
+#include "./Utils/ClassInfo.h"
+
+#include "HeapData.h"
+
+namespace duk { namespace details {
+
+/**
+ * Descriptor of a native class, one instance per type.
+ * Descriptors are chained along `BaseClass` declarations, so that pointer to object
+ * is converted to pointer to its base class with `static_cast` instead of reinterpreting it.
+ */
+struct NativeType {
+    const NativeType *base;
+    void * (*toBase)(void *obj);
+    void * (*fromBase)(void *obj);  ///< `dynamic_cast` from base class, nullptr if base is not polymorphic
+    const char *name;
+};
+
+template <class T, class B, bool Polymorphic = std::is_polymorphic<B>::value>
+struct NativeDownCast {
+    static void * cast(void *obj) { return dynamic_cast<T*>(static_cast<B*>(obj)); }
+    static constexpr void * (*get())(void *) { return &cast; }
+};
+
+template <class T, class B>
+struct NativeDownCast<T, B, false> {
+    static constexpr void * (*get())(void *) { return nullptr; }
+};
+
+template <class T, bool HasBase = BaseClass<T>::isDefined()>
+struct NativeTypeOf {
+    static const NativeType value;
+
+    static const NativeType * get() { return &value; }
+};
+
+template <class T, bool HasBase>
+const NativeType NativeTypeOf<T, HasBase>::value { nullptr, nullptr, nullptr, ClassName<T>::value };
+
+template <class T>
+struct NativeTypeOf<T, true> {
+    static const NativeType value;
+
+    static const NativeType * get() { return &value; }
+
+    static void * toBase(void *obj) {
+        return static_cast<BaseOf<T>*>(static_cast<T*>(obj));
+    }
+};
+
+template <class T>
+const NativeType NativeTypeOf<T, true>::value {
+    &NativeTypeOf<BaseOf<T>>::value,
+    &NativeTypeOf<T, true>::toBase,
+    NativeDownCast<T, BaseOf<T>>::get(),
+    ClassName<T>::value
+};
+
+/**
+ * Convert pointer to object of class `from` to pointer to class `to` derived from it (along `BaseClass`
+ * declarations) with `dynamic_cast` at every level
+ * @returns nullptr if object is not an instance of `to` or it can't be checked
+ */
+inline void * CastToDerived(void *obj, const NativeType *from, const NativeType *to) {
+    if (to == from) {
+        return obj;
+    }
+
+    if (!to->base || !to->fromBase) {
+        return nullptr;
+    }
+
+    void *base = CastToDerived(obj, from, to->base);
+    return base ? to->fromBase(base) : nullptr;
+}
+
+/**
+ * Native object referenced by a wrapper: pointer to the object and descriptor of its exact class
+ */
+struct NativeRef {
+    void *ptr;
+    const NativeType *type;
+};
+
+/**
+ * Class registered in a context (see `Context::registerClass`)
+ */
+struct RegisteredClass {
+    void *prototype;    ///< heap pointer to prototype, kept alive by the global stash
+    const NativeType *type;
+};
+
+/**
+ * Store native object reference in the wrapper at `objIdx` (hidden `obj_ptr` fixed buffer)
+ * @param extraSize size of storage reserved in the same buffer after the reference (see `PushValueObject`)
+ * @returns pointer to the buffer, reserved storage starts at `sizeof(NativeRef)`
+ */
+inline void * PutNativeRef(duk_context *d, int objIdx, NativeRef ref, std::size_t extraSize = 0) {
+    int idx = duk_normalize_index(d, objIdx);
+
+    // buffer data is not guaranteed to be aligned, so it is accessed with memcpy
+    void *buf = duk_push_fixed_buffer(d, sizeof(NativeRef) + extraSize);
+    std::memcpy(buf, &ref, sizeof(NativeRef));
+    details::PutHiddenProp(d, idx, details::HiddenKey::ObjPtr);
+
+    return buf;
+}
+
+/**
+ * Replace object pointer in the `obj_ptr` buffer
+ */
+inline void SetNativeRefPtr(void *buf, void *ptr) {
+    std::memcpy(static_cast<char*>(buf) + offsetof(NativeRef, ptr), &ptr, sizeof(void*));
+}
+
+template <class T>
+inline void PutNativeObject(duk_context *d, int objIdx, T *obj) {
+    typedef typename std::remove_cv<T>::type TC;
+    PutNativeRef(d, objIdx, NativeRef { const_cast<TC*>(obj), NativeTypeOf<TC>::get() });
+}
+
+/**
+ * Get native object reference of the value at `index` with a single property lookup
+ * @returns false if value is not a native object wrapper
+ */
+inline bool GetNativeRef(duk_context *d, int index, NativeRef &ref) {
+    details::GetHiddenProp(d, index, details::HiddenKey::ObjPtr);
+
+    duk_size_t size = 0;
+    void *buf = duk_get_buffer(d, -1, &size);
+    bool found = buf && size >= sizeof(NativeRef);
+    if (found) {
+        std::memcpy(&ref, buf, sizeof(NativeRef));
+    }
+
+    duk_pop(d);
+    return found;
+}
+
+/**
+ * Clear pointer to native object of the wrapper at `objIdx`, so that bindings raise TypeError
+ */
+inline void ResetNativeRef(duk_context *d, int objIdx) {
+    details::GetHiddenProp(d, objIdx, details::HiddenKey::ObjPtr);
+
+    duk_size_t size = 0;
+    void *buf = duk_get_buffer(d, -1, &size);
+    if (buf && size >= sizeof(NativeRef)) {
+        SetNativeRefPtr(buf, nullptr);
+    }
+
+    duk_pop(d);
+}
+
+/**
+ * Get pointer to native object of class T (or class derived from T) wrapped by the value at `index`
+ * @throws TypeError (duk_error) if value is not a wrapper of T or object is not available
+ */
+template <class T>
+inline T * GetNativeObject(duk_context *d, int index) {
+    typedef typename std::remove_cv<T>::type TC;
+
+    NativeRef ref;
+    if (!GetNativeRef(d, index, ref)) {
+        duk_error(d, DUK_ERR_TYPE_ERROR, "Expected native object of class %s", ClassName<TC>::value);
+    }
+
+    if (!ref.ptr) {
+        duk_error(d, DUK_ERR_TYPE_ERROR, "Native object is not available (borrowed object used after its scope ended?)");
+    }
+
+    const NativeType *expected = NativeTypeOf<TC>::get();
+    for (const NativeType *type = ref.type; type; type = type->base) {
+        if (type == expected) {
+            return static_cast<TC*>(ref.ptr);
+        }
+        ref.ptr = type->toBase ? type->toBase(ref.ptr) : nullptr;
+    }
+
+    duk_error(d, DUK_ERR_TYPE_ERROR, "Expected native object of class %s, got %s",
+              ClassName<TC>::value, ref.type->name);
+    return nullptr;
+}
+
+/**
+ * Same as `GetNativeObject` without checks: value at `index` must be a wrapper of T
+ * (or class derived from T) with available object
+ */
+template <class T>
+inline T * GetNativeObjectUnchecked(duk_context *d, int index) {
+    typedef typename std::remove_cv<T>::type TC;
+
+    NativeRef ref;
+    details::GetHiddenProp(d, index, details::HiddenKey::ObjPtr);
+    std::memcpy(&ref, duk_get_buffer(d, -1, nullptr), sizeof(NativeRef));
+    duk_pop(d);
+
+    const NativeType *expected = NativeTypeOf<TC>::get();
+    for (const NativeType *type = ref.type; type != expected && type->toBase; type = type->base) {
+        ref.ptr = type->toBase(ref.ptr);
+    }
+
+    return static_cast<TC*>(ref.ptr);
+}
+
+/**
+ * Selects checked or unchecked access to native object (see `UncheckedCalls`)
+ */
+template <class T, bool Unchecked>
+struct NativeObjectGetter {
+    static T * get(duk_context *d, int index) { return GetNativeObject<T>(d, index); }
+};
+
+template <class T>
+struct NativeObjectGetter<T, true> {
+    static T * get(duk_context *d, int index) { return GetNativeObjectUnchecked<T>(d, index); }
+};
+
+}}
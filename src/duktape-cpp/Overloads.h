@@ -0,0 +1,270 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <duktape.h>
+
+#include "./Utils/ClassInfo.h"
+#include "./Utils/Helpers.h"
+
+#include "Context.h"
+#include "TypeTag.h"
+#include "BindingStats.h"
+#include "Instrumentation.h"
+#include "Tracer.h"
+#include "Method.h"
+#include "Constructor.inl"
+
+namespace duk { namespace details {
+
+/**
+ * Argument count and type tags of an overload, computed at compile time.
+ * Trailing optional arguments (see `ArgIsOptional`) can be omitted.
+ */
+template <class ... A>
+struct Signature {
+    static constexpr duk_idx_t requiredArgs() {
+        constexpr bool optional[] = { ArgIsOptional<A>::value..., false };
+
+        duk_idx_t n = duk_idx_t(sizeof...(A));
+        while (n > 0 && optional[n - 1]) {
+            n -= 1;
+        }
+        return n;
+    }
+
+    static bool matches(duk_context *d, duk_idx_t nargs) {
+        static constexpr duk_uint_t tags[] = { ArgTypeTag<A>::value..., 0 };
+
+        if (nargs < requiredArgs() || nargs > duk_idx_t(sizeof...(A))) {
+            return false;
+        }
+
+        for (duk_idx_t i = 0; i < nargs; ++i) {
+            if (!(duk_get_type_mask(d, i) & tags[i])) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+};
+
+template <class M>
+struct MethodTraits;
+
+template <class C, class R, class ... A>
+struct MethodTraits<R (C::*)(A...)> {
+    typedef C Class;
+    typedef MethodDispatcher<C, R, A...> Dispatcher;
+    typedef Signature<A...> Sig;
+};
+
+template <class C, class R, class ... A>
+struct MethodTraits<R (C::*)(A...) const> {
+    typedef C Class;
+    typedef MethodDispatcher<C, R, A...> Dispatcher;
+    typedef Signature<A...> Sig;
+};
+
+template <class F>
+struct ConstructorTraits;
+
+template <class C, class ... A>
+struct ConstructorTraits<std::shared_ptr<C> (*)(A...)> {
+    typedef C Class;
+    typedef ConstructorDispatcher<0, C, A...> Dispatcher;
+    typedef Signature<A...> Sig;
+};
+
+template <class C, class ... A>
+struct ConstructorTraits<std::unique_ptr<C> (*)(A...)> {
+    typedef C Class;
+    typedef ConstructorDispatcherUnique<0, C, A...> Dispatcher;
+    typedef Signature<A...> Sig;
+};
+
+/**
+ * Trivially copyable table of overloads, stored in a fixed buffer of the dispatching function
+ * (so the function needs no finalizer)
+ */
+template <class ... F>
+struct FuncTable {};
+
+template <class F, class ... Fs>
+struct FuncTable<F, Fs...> {
+    F head;
+    FuncTable<Fs...> tail;
+};
+
+inline FuncTable<> MakeFuncTable() {
+    return FuncTable<>();
+}
+
+template <class F, class ... Fs>
+inline FuncTable<F, Fs...> MakeFuncTable(F head, Fs ... tail) {
+    return FuncTable<F, Fs...> { head, MakeFuncTable(tail...) };
+}
+
+/**
+ * Offset of entry `I` in the table
+ */
+template <std::size_t I>
+struct FuncTableOffset {
+    template <class T>
+    static constexpr std::size_t get() { return offsetof(T, tail) + FuncTableOffset<I - 1>::template get<decltype(T::tail)>(); }
+};
+
+template <>
+struct FuncTableOffset<0> {
+    template <class T>
+    static constexpr std::size_t get() { return offsetof(T, head); }
+};
+
+template <class Table>
+inline void PushFuncTable(duk_context *d, int funcIndex, Table const &table) {
+    static_assert(std::is_trivially_copyable<Table>::value, "overloads must be trivially copyable");
+
+    int fidx = duk_normalize_index(d, funcIndex);
+    void *buf = duk_push_fixed_buffer(d, sizeof(Table));
+    std::memcpy(buf, &table, sizeof(Table));
+    details::PutHiddenProp(d, fidx, details::HiddenKey::Overloads);
+}
+
+/**
+ * Get table of the running function, buffer is kept alive by the function
+ */
+inline const void * GetFuncTableBuffer(duk_context *d) {
+    duk_push_current_function(d);
+    details::GetHiddenProp(d, -1, details::HiddenKey::Overloads);
+    const void *buf = duk_get_buffer(d, -1, nullptr);
+    duk_pop_2(d);
+
+    return buf;
+}
+
+/**
+ * Read entry `I` of type `E` from the table buffer (buffer data is not guaranteed to be aligned)
+ */
+template <class E, std::size_t I, class Table>
+inline E ReadFuncTableEntry(const void *buf) {
+    E entry;
+    std::memcpy(&entry, static_cast<const char*>(buf) + FuncTableOffset<I>::template get<Table>(), sizeof(E));
+    return entry;
+}
+
+/**
+ * Set of methods registered under one name.
+ * Overload is selected by number of arguments and their type tags (see `ArgTypeTag`),
+ * the first matching overload in registration order is called.
+ */
+template <class ... M>
+struct MethodOverloads {
+    typedef FuncTable<M...> Table;
+    typedef typename MethodTraits<typename std::tuple_element<0, std::tuple<M...>>::type>::Class Class;
+
+    static void push(duk::Context &d, M ... methods) {
+        auto fidx = duk_push_c_function(d, func, DUK_VARARGS);
+        PushFuncTable(d, fidx, MakeFuncTable(methods...));
+    }
+
+    static duk_ret_t func(duk_context *d) {
+        return InstrumentedCall(d, call, CurrentBindingStats(d), CurrentTraceName(d, ClassName<Class>::value), "method");
+    }
+
+    static duk_ret_t call(duk_context *d) {
+        Context &ctx = Context::GetSelfFromContext(d);
+        Context::ThreadScope scope(ctx, d);
+
+        duk_idx_t nargs = duk_get_top(d);
+
+        duk_push_this(d);
+        Class *objPtr = NativeObjectGetter<Class, UncheckedCalls<Class>::value>::get(d, -1);
+        duk_pop(d);
+
+        const void *table = GetFuncTableBuffer(d);
+        return dispatch<0>(table, objPtr, ctx, nargs, std::integral_constant<bool, 0 < sizeof...(M)>{});
+    }
+
+    template <std::size_t I>
+    static duk_ret_t dispatch(const void *table, Class *objPtr, duk::Context &d, duk_idx_t nargs, std::true_type) {
+        typedef typename std::tuple_element<I, std::tuple<M...>>::type Mi;
+        typedef MethodTraits<Mi> Traits;
+
+        if (Traits::Sig::matches(d, nargs)) {
+            typename Traits::Dispatcher dispatcher;
+            auto method = std::mem_fn(ReadFuncTableEntry<Mi, I, Table>(table));
+            return dispatcher.dispatch(method, static_cast<typename Traits::Class*>(objPtr), d);
+        }
+
+        return dispatch<I + 1>(table, objPtr, d, nargs, std::integral_constant<bool, I + 1 < sizeof...(M)>{});
+    }
+
+    template <std::size_t I>
+    static duk_ret_t dispatch(const void *, Class *, duk::Context &d, duk_idx_t, std::false_type) {
+        duk_error(d, DUK_ERR_TYPE_ERROR, "No overload of the method matches arguments");
+        return DUK_RET_TYPE_ERROR;
+    }
+};
+
+/**
+ * Set of constructors of a class, selected the same way as methods (see `MethodOverloads`)
+ */
+template <class ... F>
+struct ConstructorOverloads {
+    typedef FuncTable<F...> Table;
+    typedef typename ConstructorTraits<typename std::tuple_element<0, std::tuple<F...>>::type>::Class Class;
+
+    static void push(duk::Context &d, F ... constructors) {
+        auto fidx = duk_push_c_function(d, func, DUK_VARARGS);
+        PushFuncTable(d, fidx, MakeFuncTable(constructors...));
+        AttachBindingStats(d, fidx, ClassName<Class>::value, "constructor");
+    }
+
+    static duk_ret_t func(duk_context *d) {
+        return InstrumentedCall(d, call, CurrentBindingStats(d), ClassName<Class>::value, "constructor");
+    }
+
+    static duk_ret_t call(duk_context *d) {
+        if (!UncheckedCalls<Class>::value && !duk_is_constructor_call(d)) {
+            duk_error(d, DUK_RET_TYPE_ERROR, "Constructor must be called with 'new'.");
+            return DUK_RET_TYPE_ERROR;
+        }
+
+        Context &ctx = Context::GetSelfFromContext(d);
+        Context::ThreadScope scope(ctx, d);
+
+        duk_idx_t nargs = duk_get_top(d);
+
+        const void *table = GetFuncTableBuffer(d);
+        return dispatch<0>(table, ctx, nargs, std::integral_constant<bool, 0 < sizeof...(F)>{});
+    }
+
+    template <std::size_t I>
+    static duk_ret_t dispatch(const void *table, duk::Context &d, duk_idx_t nargs, std::true_type) {
+        typedef typename std::tuple_element<I, std::tuple<F...>>::type Fi;
+        typedef ConstructorTraits<Fi> Traits;
+
+        if (Traits::Sig::matches(d, nargs)) {
+            typename Traits::Dispatcher dispatcher;
+            return dispatcher.dispatch(ReadFuncTableEntry<Fi, I, Table>(table), d);
+        }
+
+        return dispatch<I + 1>(table, d, nargs, std::integral_constant<bool, I + 1 < sizeof...(F)>{});
+    }
+
+    template <std::size_t I>
+    static duk_ret_t dispatch(const void *, duk::Context &d, duk_idx_t, std::false_type) {
+        duk_error(d, DUK_ERR_TYPE_ERROR, "No overload of the constructor matches arguments");
+        return DUK_RET_TYPE_ERROR;
+    }
+};
+
+}}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include <duktape.h>
+
+namespace duk {
+
+class Context;
+
+/**
+ * @brief Sampling profiler of scripts running in a context
+ * @details Call stack is sampled from the executor interrupt hook, so the library
+ *          must be built with DUK_CPP_ENABLE_INTERRUPT_HOOK CMake option.
+ *          Without the option interrupt counter is compiled out of duktape and there is no overhead.
+ *          With the option enabled, stack is walked at most once per sampling interval
+ *          (and not more often than every 256k executed instructions).
+ *
+ * Samples are aggregated by call stacks, each frame is identified by function name,
+ * file name (script id of the context for evaluated code) and line.
+ * Stack of the interrupted thread is read without allocations in the heap and includes
+ * frames of the threads which resumed it (see `Coroutine`).
+ */
+class Profiler {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * Maximum number of sampled frames, frames closest to the root are dropped
+     */
+    static constexpr int MaxDepth = 128;
+
+    /**
+     * @param ctx context to profile
+     * @param interval sampling interval
+     */
+    explicit Profiler(Context &ctx, Clock::duration interval = std::chrono::milliseconds(1));
+    ~Profiler();
+
+    Profiler(const Profiler &) = delete;
+    Profiler & operator = (const Profiler &) = delete;
+
+    /**
+     * @brief Start sampling
+     * @throws DuktapeException if library is built without interrupt hook
+     */
+    void start();
+
+    /**
+     * @brief Stop sampling, collected samples are kept
+     */
+    void stop();
+
+    bool isRunning() const { return _running; }
+
+    /**
+     * @brief Remove collected samples
+     */
+    void reset();
+
+    /**
+     * @brief Get number of collected samples
+     */
+    std::uint64_t numSamples() const { return _numSamples; }
+
+    /**
+     * @brief Export samples in collapsed stack format (`frame;frame;frame count` per line),
+     *        which can be used to build flamegraphs (e.g. with flamegraph.pl)
+     */
+    std::string collapsedStacks() const;
+
+private:
+    Context &_ctx;
+    Clock::duration _interval;
+    Clock::time_point _nextSample;
+    bool _running { false };
+    std::uint64_t _numSamples { 0 };
+    std::unordered_map<std::string, std::uint64_t> _stacks;
+
+    void sample();
+    void appendFrame(std::string &stack, duk_cpp_frame const &frame) const;
+
+    static bool onInterrupt(void *data);
+};
+
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "Profiler.h"
+#include "Context.h"
+#include "Exceptions.h"
+
+namespace duk {
+
+inline Profiler::Profiler(Context &ctx, Clock::duration interval)
+    : _ctx(ctx), _interval(interval) {}
+
+inline Profiler::~Profiler() {
+    stop();
+}
+
+inline void Profiler::start() {
+    if (!Context::HasInterruptHook()) {
+        throw DuktapeException("Profiler requires library built with DUK_CPP_ENABLE_INTERRUPT_HOOK option");
+    }
+
+    _nextSample = Clock::now() + _interval;
+    _running = true;
+    _ctx.setInterruptHandler(onInterrupt, this);
+}
+
+inline void Profiler::stop() {
+    if (_running) {
+        _ctx.setInterruptHandler(nullptr, nullptr);
+        _running = false;
+    }
+}
+
+inline void Profiler::reset() {
+    _stacks.clear();
+    _numSamples = 0;
+}
+
+inline std::string Profiler::collapsedStacks() const {
+    std::vector<std::pair<std::string, std::uint64_t>> stacks(_stacks.begin(), _stacks.end());
+    std::sort(stacks.begin(), stacks.end());
+
+    std::string res;
+    for (auto const &s : stacks) {
+        res += s.first;
+        res += ' ';
+        res += std::to_string(s.second);
+        res += '\n';
+    }
+
+    return res;
+}
+
+inline bool Profiler::onInterrupt(void *data) {
+    auto *self = reinterpret_cast<Profiler*>(data);
+
+    auto now = Clock::now();
+    if (now >= self->_nextSample) {
+        self->_nextSample = now + self->_interval;
+        self->sample();
+    }
+
+    // never abort execution
+    return false;
+}
+
+inline void Profiler::sample() {
+    // interrupt must not allocate in the heap: GC and finalizers could run in the middle of executor
+    duk_cpp_frame frames[MaxDepth];
+    duk_int_t depth = duk_cpp_sample_callstack(_ctx.ptr(), frames, MaxDepth);
+
+    // frames are sampled from the innermost one, stack is printed from root to leaf
+    std::string stack;
+    for (duk_int_t i = depth - 1; i >= 0; --i) {
+        if (!stack.empty()) {
+            stack += ';';
+        }
+        appendFrame(stack, frames[i]);
+    }
+
+    if (!stack.empty()) {
+        _stacks[stack] += 1;
+        _numSamples += 1;
+    }
+}
+
+inline void Profiler::appendFrame(std::string &stack, duk_cpp_frame const &frame) const {
+    if (frame.name && frame.name_len > 0) {
+        stack.append(frame.name, frame.name_len);
+    }
+    else {
+        stack += "(anonymous)";
+    }
+
+    if (frame.is_native) {
+        stack += " [native]";
+        return;
+    }
+
+    std::string file = frame.file_name ? std::string(frame.file_name, frame.file_name_len) : "";
+    if ((file.empty() || file == "eval") && !_ctx.scriptId().empty()) {
+        file = _ctx.scriptId();
+    }
+
+    stack += " (" + file + ":" + std::to_string(frame.line) + ")";
+}
+
+}
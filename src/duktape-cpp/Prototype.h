@@ -0,0 +1,160 @@
+#pragma once
+
+#include <string>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
+
+#include <duktape.h>
+
+#include "./Utils/ClassInfo.h"
+#include "./Utils/Inspect.h"
+
+#include "Context.h"
+#include "NativeObject.h"
+#include "PushObjectInspector.h"
+#include "LightFunc.h"
+#include "BindingPlan.h"
+#include "BindingStats.h"
+#include "Tracer.h"
+
+namespace duk { namespace details {
+
+template <class T>
+inline void PushPrototype(duk::Context &d);
+
+template <class T, bool HasBase = BaseClass<T>::isDefined()>
+struct BasePrototype {
+    static void set(duk::Context &, int) {}
+};
+
+template <class T>
+struct BasePrototype<T, true> {
+    static void set(duk::Context &d, int protoIdx) {
+        PushPrototype<BaseOf<T>>(d);
+        duk_set_prototype(d, protoIdx);
+    }
+};
+
+/**
+ * Push native function recorded in binding plan
+ */
+inline void PushPlanFunction(duk::Context &d, PlanFunction const &f) {
+    if (f.pushIndexed) {
+        f.pushIndexed(d, std::size_t(f.magic));
+        return;
+    }
+
+    duk_push_c_function(d, f.func, f.nargs);
+    duk_set_magic(d, -1, f.magic);
+
+    if (f.stats) {
+        AttachBindingStatsRecord(d, -1, f.stats);
+    }
+    if (f.traceName) {
+        AttachTraceName(d, -1, f.traceName);
+    }
+}
+
+/**
+ * Define properties recorded in binding plan on object at `objIdx`
+ */
+inline void ApplyPlanSteps(duk::Context &d, int objIdx, std::vector<PlanStep> const &steps) {
+    for (PlanStep const &step : steps) {
+        duk_push_lstring(d, step.name.data(), step.name.size());
+        if (step.push) {
+            step.push(d);
+        }
+        else {
+            PushPlanFunction(d, step.value);
+            if (step.setter.isSet()) {
+                PushPlanFunction(d, step.setter);
+            }
+        }
+        duk_def_prop(d, objIdx, step.flags);
+    }
+}
+
+/**
+ * Push prototype object with methods and properties of class T (see `Inspect`).
+ * Prototype is created on first use and cached per context by `TypeSlot` of T,
+ * so wrappers inheriting from it don't need own method functions and finalizers.
+ * Prototype has only members declared by T, its own prototype is prototype of
+ * the base class (see `BaseClass`), so hierarchies form javascript prototype chains.
+ * Classes registered in `TypeRegistry` are built from their binding plan instead of inspection.
+ */
+template <class T>
+inline void PushPrototype(duk::Context &d) {
+    HeapData &heapData = GetHeapData(d);
+    std::size_t slot = TypeSlot<T>::get();
+
+    if (slot < heapData.prototypes.size() && heapData.prototypes[slot]) {
+        duk_push_heapptr(d, heapData.prototypes[slot]);
+        return;
+    }
+
+    auto protoIdx = duk_push_object(d);
+    if (const ClassPlan *plan = ClassPlanOf<T>::get()) {
+        ApplyPlanSteps(d, protoIdx, plan->prototype);
+    }
+    else {
+        typename PrototypeInspector<T>::type i(d, protoIdx);
+        InspectOwn<T>::inspect(i);
+    }
+
+    BasePrototype<T>::set(d, protoIdx);
+
+    // keep prototype reachable, vector may be reallocated while base prototypes are built
+    duk_push_heapptr(d, heapData.prototypeStore);
+    duk_dup(d, protoIdx);
+    duk_put_prop_index(d, -2, duk_uarridx_t(slot));
+    duk_pop(d);
+
+    if (heapData.prototypes.size() <= slot) {
+        heapData.prototypes.resize(slot + 1, nullptr);
+    }
+    heapData.prototypes[slot] = duk_get_heapptr(d, protoIdx);
+}
+
+template <class T, bool Polymorphic = IsPolymorphic<T>::value() && std::is_polymorphic<T>::value>
+struct MostDerivedPrototype {
+    static NativeRef push(duk::Context &d, T *obj) {
+        PushPrototype<T>(d);
+        return NativeRef { obj, NativeTypeOf<T>::get() };
+    }
+};
+
+template <class T>
+struct MostDerivedPrototype<T, true> {
+    static NativeRef push(duk::Context &d, T *obj) {
+        std::type_index type(typeid(*obj));
+        if (RegisteredClass const *cls = d.registeredClass(type)) {
+            duk_push_heapptr(d, cls->prototype);
+            return NativeRef { dynamic_cast<void*>(obj), cls->type };
+        }
+
+        void *ptr = obj;
+        if (RegisteredClass const *cls = d.registeredAncestor(type, ptr, NativeTypeOf<T>::get())) {
+            duk_push_heapptr(d, cls->prototype);
+            return NativeRef { CastToDerived(ptr, NativeTypeOf<T>::get(), cls->type), cls->type };
+        }
+
+        PushPrototype<T>(d);
+        return NativeRef { obj, NativeTypeOf<T>::get() };
+    }
+};
+
+/**
+ * Push prototype for wrapper of `obj` and get native object reference to store in the wrapper
+ * (see `PutNativeRef`). For classes marked with `DUK_CPP_DEF_POLYMORPHIC` the dynamic type
+ * of `obj` is looked up among registered classes (single hash lookup), so the wrapper exposes
+ * methods of the most-derived class and references the most-derived object.
+ * If dynamic type is not registered, the most-derived registered class it inherits from is used
+ * (see `Context::registeredAncestor`). Otherwise prototype of T is used.
+ */
+template <class T>
+inline NativeRef PushMostDerivedPrototype(duk::Context &d, T *obj) {
+    return MostDerivedPrototype<T>::push(d, obj);
+}
+
+}}
@@ -4,6 +4,7 @@
 
 #include "EmptyInspector.h"
 #include "Constructor.h"
+#include "Overloads.h"
 
 namespace duk { namespace details {
 
@@ -28,6 +29,20 @@ public:
         }
     }
 
+    /**
+     * Bind overloaded constructors, selected by number of arguments and their types
+     * (see `MethodOverloads`)
+     */
+    template <class F1, class F2, class ... F>
+    void construct(F1 constructor1, F2 constructor2, F ... constructors) {
+        if (!_hasConstructor) {
+            _hasConstructor = true;
+            ConstructorOverloads<F1, F2, F...>::push(_ctx, constructor1, constructor2, constructors...);
+        }
+    }
+
+    bool hasConstructor() const { return _hasConstructor; }
+
 private:
     duk::Context &_ctx;
     bool _hasConstructor = false;
@@ -29,7 +29,27 @@ public:
     template <class C, class R, class ... A>
     void method(const char *name, R(C::*method)(A...) const);
 
-private:
+    /**
+     * Bind overloaded methods under one name.
+     * Overload is selected by number of arguments and their types (numbers, booleans, strings),
+     * the first matching method is called.
+     */
+    template <class M1, class M2, class ... M>
+    void method(const char *name, M1 method1, M2 method2, M ... methods);
+
+    /**
+     * Bind method which runs on the thread pool of context's event loop (see EventLoop).
+     * Script receives thenable object resolved with method result.
+     * Wrapper of the object is kept alive until the result is settled,
+     * borrowed objects (see `Borrowed`) must outlive the call.
+     */
+    template <class C, class R, class ... A>
+    void asyncMethod(const char *name, R(C::*method)(A...));
+
+    template <class C, class R, class ... A>
+    void asyncMethod(const char *name, R(C::*method)(A...) const);
+
+protected:
     duk::Context &_d;
     int _objIdx;
 };
@@ -3,6 +3,10 @@
 #include "PushObjectInspector.h"
 
 #include "Method.h"
+#include "Overloads.h"
+#include "BindingStats.h"
+#include "Tracer.h"
+#include "./Utils/ClassInfo.h"
 
 namespace duk { namespace details {
 
@@ -10,7 +14,11 @@ template <class C, class A>
 inline void PushObjectInspector::property(const char *name, Getter<C, A> getter, Setter<C, A> setter) {
     duk_push_string(_d, name);
     PushMethod(_d, getter);
+    AttachBindingStats(_d, -1, ClassName<C>::value, "get ", name);
+    AttachTraceName(_d, -1, ClassName<C>::value, "get ", name);
     PushMethod(_d, setter);
+    AttachBindingStats(_d, -1, ClassName<C>::value, "set ", name);
+    AttachTraceName(_d, -1, ClassName<C>::value, "set ", name);
     duk_def_prop(
         _d,
         _objIdx,
@@ -23,6 +31,8 @@ template <class C, class A>
 inline void PushObjectInspector::property(const char *name, Getter<C, A> getter) {
     duk_push_string(_d, name);
     PushMethod(_d, getter);
+    AttachBindingStats(_d, -1, ClassName<C>::value, "get ", name);
+    AttachTraceName(_d, -1, ClassName<C>::value, "get ", name);
     duk_def_prop(
         _d,
         _objIdx,
@@ -33,12 +43,40 @@ inline void PushObjectInspector::property(const char *name, Getter<C, A> getter)
 template <class C, class R, class ... A>
 inline void PushObjectInspector::method(const char *name, R(C::*method)(A...)) {
     PushMethod(_d, method);
+    AttachBindingStats(_d, -1, ClassName<C>::value, name);
+    AttachTraceName(_d, -1, ClassName<C>::value, name);
     duk_put_prop_string(_d, _objIdx, name);
 }
 
 template <class C, class R, class ... A>
 inline void PushObjectInspector::method(const char *name, R(C::*method)(A...) const) {
     PushMethod(_d, method);
+    AttachBindingStats(_d, -1, ClassName<C>::value, name);
+    AttachTraceName(_d, -1, ClassName<C>::value, name);
+    duk_put_prop_string(_d, _objIdx, name);
+}
+
+template <class M1, class M2, class ... M>
+inline void PushObjectInspector::method(const char *name, M1 method1, M2 method2, M ... methods) {
+    MethodOverloads<M1, M2, M...>::push(_d, method1, method2, methods...);
+    AttachBindingStats(_d, -1, ClassName<typename MethodTraits<M1>::Class>::value, name);
+    AttachTraceName(_d, -1, ClassName<typename MethodTraits<M1>::Class>::value, name);
+    duk_put_prop_string(_d, _objIdx, name);
+}
+
+template <class C, class R, class ... A>
+inline void PushObjectInspector::asyncMethod(const char *name, R(C::*method)(A...)) {
+    PushAsyncMethod(_d, method);
+    AttachBindingStats(_d, -1, ClassName<C>::value, name);
+    AttachTraceName(_d, -1, ClassName<C>::value, name);
+    duk_put_prop_string(_d, _objIdx, name);
+}
+
+template <class C, class R, class ... A>
+inline void PushObjectInspector::asyncMethod(const char *name, R(C::*method)(A...) const) {
+    PushAsyncMethod(_d, method);
+    AttachBindingStats(_d, -1, ClassName<C>::value, name);
+    AttachTraceName(_d, -1, ClassName<C>::value, name);
     duk_put_prop_string(_d, _objIdx, name);
 }
 
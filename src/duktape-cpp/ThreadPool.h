@@ -0,0 +1,113 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace duk {
+
+/**
+ * @brief Fixed size pool of worker threads
+ * @details Used by EventLoop to run async native methods off the script thread.
+ */
+class ThreadPool {
+public:
+    /**
+     * @param numThreads number of worker threads
+     */
+    explicit ThreadPool(std::size_t numThreads = DefaultNumThreads()) {
+        if (numThreads == 0) {
+            numThreads = 1;
+        }
+
+        _workers.reserve(numThreads);
+        for (std::size_t i = 0; i < numThreads; ++i) {
+            _workers.emplace_back([this] { work(); });
+        }
+    }
+
+    /**
+     * @brief Finish queued tasks and join worker threads
+     */
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopped = true;
+        }
+        _cv.notify_all();
+
+        for (auto &w : _workers) {
+            w.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool & operator = (const ThreadPool &) = delete;
+
+    static std::size_t DefaultNumThreads() {
+        std::size_t n = std::thread::hardware_concurrency();
+        return n > 0 ? n : 2;
+    }
+
+    std::size_t size() const { return _workers.size(); }
+
+    /**
+     * @brief Run task on one of the worker threads
+     */
+    void post(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _tasks.push_back(std::move(task));
+        }
+        _cv.notify_one();
+    }
+
+    /**
+     * @brief Run function on one of the worker threads
+     * @returns future with function result
+     */
+    template <class F>
+    auto submit(F &&f) -> std::future<decltype(f())> {
+        typedef decltype(f()) R;
+
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+        std::future<R> res = task->get_future();
+        post([task] { (*task)(); });
+
+        return res;
+    }
+
+private:
+    std::vector<std::thread> _workers;
+    std::deque<std::function<void()>> _tasks;
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    bool _stopped { false };
+
+    void work() {
+        while (true) {
+            std::function<void()> task;
+
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _cv.wait(lock, [this] { return _stopped || !_tasks.empty(); });
+
+                if (_tasks.empty()) {
+                    return;
+                }
+
+                task = std::move(_tasks.front());
+                _tasks.pop_front();
+            }
+
+            task();
+        }
+    }
+};
+
+}
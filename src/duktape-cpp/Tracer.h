@@ -0,0 +1,332 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <duktape.h>
+
+#include "HeapData.h"
+
+namespace duk {
+
+/**
+ * @brief Timeline of script evaluations, native calls, finalizers and garbage collections
+ * @details Trace points are compiled only if library is built with DUK_CPP_ENABLE_TRACING
+ *          CMake option, otherwise they compile to nothing and trace is always empty.
+ *          Each thread writes complete events (start and duration) to its own ring buffer
+ *          without locking, when buffer is full the oldest events are overwritten.
+ *          Native bindings run in a protected call while tracing, so calls aborted
+ *          by script errors are recorded too.
+ *          Methods, accessors and static methods are named `Class.member` (`Class.get member` for accessors).
+ *
+ * Trace is exported in Chrome trace event format (open in chrome://tracing or Perfetto).
+ */
+class Tracer {
+public:
+    /**
+     * Number of events kept per thread
+     */
+    static constexpr std::size_t EventsPerThread = 1 << 16;
+
+    static constexpr bool IsEnabled() {
+#if defined(DUK_CPP_TRACING)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Start recording events
+     */
+    static void Start() { State().running.store(true, std::memory_order_relaxed); }
+
+    /**
+     * @brief Stop recording events, recorded events are kept
+     */
+    static void Stop() { State().running.store(false, std::memory_order_relaxed); }
+
+    static bool IsRunning() { return State().running.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Remove recorded events of all threads
+     * @remarks should be called while traced threads don't record events
+     */
+    static void Clear();
+
+    /**
+     * @brief Export recorded events as Chrome trace JSON
+     * @remarks should be called while traced threads don't record events (e.g. after `Stop`)
+     */
+    static std::string ChromeTraceJson();
+
+    /**
+     * @brief Record begin of event
+     * @param name event name, must be a string with static storage duration
+     * @param category event category, must be a string with static storage duration
+     */
+    static void Begin(const char *name, const char *category) { record(name, category, 'B'); }
+
+    /**
+     * @brief Record end of event (see `Begin`)
+     */
+    static void End(const char *name, const char *category) { record(name, category, 'E'); }
+
+    /**
+     * @brief Get timestamp for `Complete`
+     */
+    static std::int64_t Now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - State().origin).count();
+    }
+
+    /**
+     * @brief Record complete event which started at `start` (see `Now`) and ends now
+     * @param name event name, must be a string with static storage duration
+     * @param category event category, must be a string with static storage duration
+     */
+    static void Complete(const char *name, const char *category, std::int64_t start) {
+        record(name, category, 'X', start);
+    }
+
+private:
+    struct Event {
+        const char *name;
+        const char *category;
+        std::int64_t timestamp;
+        std::int64_t duration;
+        char phase;
+    };
+
+    /**
+     * Ring buffer written by a single thread
+     */
+    struct Buffer {
+        explicit Buffer(int tid) : tid(tid), events(EventsPerThread) {}
+
+        int tid;
+        std::vector<Event> events;
+        std::atomic<std::uint64_t> written { 0 };
+    };
+
+    struct GlobalState {
+        std::atomic<bool> running { false };
+        std::mutex mutex;
+        std::vector<std::shared_ptr<Buffer>> buffers;
+        std::chrono::steady_clock::time_point origin { std::chrono::steady_clock::now() };
+    };
+
+    static GlobalState & State() {
+        static GlobalState state;
+        return state;
+    }
+
+    static Buffer & ThreadBuffer() {
+        thread_local std::shared_ptr<Buffer> buffer;
+        if (!buffer) {
+            GlobalState &state = State();
+            std::lock_guard<std::mutex> lock(state.mutex);
+            buffer = std::make_shared<Buffer>(int(state.buffers.size()) + 1);
+            state.buffers.push_back(buffer);
+        }
+        return *buffer;
+    }
+
+    /**
+     * Record event, complete events start at `start`, other events have no duration and happen now
+     */
+    static void record(const char *name, const char *category, char phase, std::int64_t start = -1) {
+        GlobalState &state = State();
+        if (!state.running.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        Buffer &b = ThreadBuffer();
+        std::uint64_t idx = b.written.load(std::memory_order_relaxed);
+        std::int64_t now = Now();
+
+        Event &e = b.events[idx % EventsPerThread];
+        e.name = name;
+        e.category = category;
+        e.phase = phase;
+        e.timestamp = start < 0 ? now : start;
+        e.duration = now - e.timestamp;
+
+        b.written.store(idx + 1, std::memory_order_release);
+    }
+
+    static void AppendJsonTime(std::string &out, std::int64_t ns) {
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), "%lld.%03lld",
+                      static_cast<long long>(ns / 1000),
+                      static_cast<long long>(ns % 1000));
+        out += buf;
+    }
+
+    static void AppendJsonString(std::string &out, const char *str) {
+        out += '"';
+        for (const char *c = str; *c; ++c) {
+            switch (*c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                default:
+                    if (static_cast<unsigned char>(*c) < 0x20) {
+                        char buf[8];
+                        std::snprintf(buf, sizeof(buf), "\\u%04x", *c);
+                        out += buf;
+                    }
+                    else {
+                        out += *c;
+                    }
+            }
+        }
+        out += '"';
+    }
+};
+
+inline void Tracer::Clear() {
+    GlobalState &state = State();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    for (auto &b : state.buffers) {
+        b->written.store(0, std::memory_order_release);
+    }
+}
+
+inline std::string Tracer::ChromeTraceJson() {
+    GlobalState &state = State();
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    std::string res = "{\"traceEvents\":[";
+    bool first = true;
+
+    for (auto const &b : state.buffers) {
+        std::uint64_t end = b->written.load(std::memory_order_acquire);
+        std::uint64_t begin = end > EventsPerThread ? end - EventsPerThread : 0;
+
+        for (std::uint64_t i = begin; i < end; ++i) {
+            Event const &e = b->events[i % EventsPerThread];
+
+            if (!first) {
+                res += ',';
+            }
+            first = false;
+
+            res += "{\"name\":";
+            AppendJsonString(res, e.name);
+            res += ",\"cat\":";
+            AppendJsonString(res, e.category);
+            res += ",\"ph\":\"";
+            res += e.phase;
+            res += "\",\"ts\":";
+            AppendJsonTime(res, e.timestamp);
+            if (e.phase == 'X') {
+                res += ",\"dur\":";
+                AppendJsonTime(res, e.duration);
+            }
+            res += ",\"pid\":1,\"tid\":";
+            res += std::to_string(b->tid);
+            res += '}';
+        }
+    }
+
+    res += "]}";
+    return res;
+}
+
+namespace details {
+
+#if defined(DUK_CPP_TRACING)
+
+/**
+ * Event name of a binding (`Class.prefixmember`), interned for the lifetime of the process
+ */
+inline const char * TraceName(const char *className, const char *prefix, const char *member) {
+    static std::mutex mutex;
+    static std::unordered_set<std::string> names;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    return names.insert(std::string(className) + "." + prefix + member).first->c_str();
+}
+
+/**
+ * Attach event name (see `TraceName`) to the native function at `funcIndex`
+ */
+inline void AttachTraceName(duk_context *d, int funcIndex, const char *name) {
+    int fidx = duk_normalize_index(d, funcIndex);
+    duk_push_pointer(d, const_cast<char*>(name));
+    details::PutHiddenProp(d, fidx, details::HiddenKey::TraceName);
+}
+
+inline void AttachTraceName(duk_context *d, int funcIndex, const char *className, const char *prefix, const char *member) {
+    AttachTraceName(d, funcIndex, TraceName(className, prefix, member));
+}
+
+inline void AttachTraceName(duk_context *d, int funcIndex, const char *className, const char *member) {
+    AttachTraceName(d, funcIndex, className, "", member);
+}
+
+/**
+ * Event name of the currently running native function (see `AttachTraceName`) or `fallback`
+ */
+inline const char * CurrentTraceName(duk_context *d, const char *fallback) {
+    if (!Tracer::IsRunning()) {
+        return fallback;
+    }
+
+    duk_push_current_function(d);
+    details::GetHiddenProp(d, -1, details::HiddenKey::TraceName);
+    const void *name = duk_get_pointer(d, -1);
+    duk_pop_2(d);
+
+    return name ? static_cast<const char*>(name) : fallback;
+}
+
+/**
+ * Records complete event of the enclosing scope when it ends.
+ * Scope skipped by Duktape error leaves no event, so bindings are traced by `InstrumentedCall`.
+ */
+class TraceScope {
+public:
+    TraceScope(const char *name, const char *category)
+        : _name(name), _category(category), _start(Tracer::Now()) {}
+
+    ~TraceScope() {
+        Tracer::Complete(_name, _category, _start);
+    }
+
+    TraceScope(const TraceScope &) = delete;
+    TraceScope & operator = (const TraceScope &) = delete;
+
+private:
+    const char *_name;
+    const char *_category;
+    std::int64_t _start;
+};
+
+#else
+
+inline const char * TraceName(const char *, const char *, const char *) { return nullptr; }
+inline void AttachTraceName(duk_context *, int, const char *) {}
+inline void AttachTraceName(duk_context *, int, const char *, const char *, const char *) {}
+inline void AttachTraceName(duk_context *, int, const char *, const char *) {}
+
+inline const char * CurrentTraceName(duk_context *, const char *fallback) { return fallback; }
+
+class TraceScope {
+public:
+    TraceScope(const char *, const char *) {}
+};
+
+#endif
+
+}
+
+}
@@ -2,6 +2,8 @@
 
 #include <duktape.h>
 
+#include "./Utils/ClassInfo.h"
+
 #include "Context.h"
 
 namespace duk {
@@ -10,16 +12,25 @@ class Context;
 
 /**
  * Type that can be converted to/from javascript
+ * @tparam Enable allows partial specializations for groups of types (e.g. enums)
  */
-template <class T>
+template <class T, class Enable = void>
 struct Type {
     /**
-     * Push value to stack
+     * Push value to stack, objects are copied into storage owned by the wrapper (see `PushValueObject`).
+     * Use `Borrow` or `std::shared_ptr` to push object without copying it.
      * @param d pointer to duktape context
      * @param val value
      */
     static void push(duk::Context &d, T const &val);
 
+    /**
+     * Push value to stack, objects are moved into storage owned by the wrapper
+     * @param d pointer to duktape context
+     * @param val value
+     */
+    static void push(duk::Context &d, T &&val);
+
     /**
      * Get value of type T from stack at specified index
      * @param[in] d pointer to duktape context
@@ -33,4 +44,39 @@ struct Type {
     static constexpr bool isPrimitive() { return false; };
 };
 
+namespace details {
+
+/**
+ * Bindings of class C are called without checks (see `IsTrusted`), checks are kept in debug builds
+ */
+template <class C>
+struct UncheckedCalls {
+#if defined(NDEBUG)
+    static constexpr bool value = IsTrusted<C>::value();
+#else
+    static constexpr bool value = false;
+#endif
+};
+
+/**
+ * Conversion used by unchecked bindings (see `UncheckedCalls`), same as `Type` by default.
+ * Primitive types read values without type checks.
+ */
+template <class T>
+struct UncheckedType: Type<T> {};
+
+/**
+ * Push object owned by javascript (object is moved into storage inside of the wrapper)
+ */
+template <class T>
+void PushValueObject(duk::Context &d, T &&value);
+
+/**
+ * Push wrapper referencing object owned by native code (pushes null for nullptr)
+ */
+template <class T>
+void PushReferenceObject(duk::Context &d, T *obj);
+
+}
+
 }
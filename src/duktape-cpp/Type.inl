@@ -1,36 +1,139 @@
 #include "Type.h"
 
 #include <cassert>
+#include <memory>
+#include <new>
+#include <type_traits>
 
 #include <duktape.h>
 
 #include <duktape-cpp/PushObjectInspector.h>
 
+#include "./Utils/ClassInfo.h"
 #include "./Utils/Helpers.h"
 #include "./Utils/Inspect.h"
 
+#include "NativeObject.h"
+#include "Prototype.h"
+#include "Tracer.h"
+
 namespace duk {
 
+namespace details {
+
+/**
+ * Destroys object stored in the wrapper by `PushValueObject`
+ */
 template <class T>
-inline void Type<T>::push(duk::Context &d, T const &value) {
-    auto objIdx = duk_push_object(d);
-    duk_push_pointer(d, const_cast<T*>(&value));
-    duk_put_prop_string(d, -2, "\xff" "obj_ptr");
-    details::PushObjectInspector i(d, objIdx);
-    Inspect<T>::inspect(i);
+inline duk_ret_t ValueObjectFinalizer(duk_context *d) {
+    TraceScope trace(ClassName<T>::value, "finalizer");
+    Context::CountFinalizer(d);
+
+    NativeRef ref;
+    if (GetNativeRef(d, 0, ref) && ref.ptr) {
+        static_cast<T*>(ref.ptr)->~T();
+
+        // object may be rescued by finalizer of another object, don't destroy it twice
+        ResetNativeRef(d, 0);
+    }
+
+    return 0;
 }
 
+/**
+ * Push object owned by javascript.
+ * Value is moved into the `obj_ptr` fixed buffer of the wrapper, right after the object reference,
+ * so it is freed by duktape GC together with the wrapper. The wrapper itself is a second allocation:
+ * prototype, finalizer and hidden properties can only be attached to an object, not to a plain buffer.
+ * Destructor is called from finalizer which is set only for non-trivially destructible types.
+ * Methods and properties are inherited from prototype of the class (see `PushPrototype`).
+ */
 template <class T>
-inline void Type<T>::get(duk::Context &d, T &value, int objIdx) {
-    static_assert(std::is_copy_constructible<T>::value, "object must be copy constructible");
+inline void PushValueObject(duk::Context &d, T &&value) {
+    typedef ClearType<T> TC;
+
+    duk_push_object(d);
+
+    // buffer is not guaranteed to be aligned, reserve space to align object
+    std::size_t size = sizeof(TC) + alignof(TC) - 1;
+    void *buf = PutNativeRef(d, -1, NativeRef { nullptr, NativeTypeOf<TC>::get() }, size);
+    void *ptr = static_cast<char*>(buf) + sizeof(NativeRef);
+
+    std::align(alignof(TC), sizeof(TC), ptr, size);
+    TC *obj = new (ptr) TC(std::forward<T>(value));
+
+    // reference is set once the object is constructed
+    SetNativeRefPtr(buf, obj);
+
+    if (!std::is_trivially_destructible<TC>::value) {
+        duk_push_c_function(d, ValueObjectFinalizer<TC>, 1);
+        duk_set_finalizer(d, -2);
+    }
+
+    PushPrototype<TC>(d);
+    duk_set_prototype(d, -2);
+}
+
+/**
+ * Push wrapper referencing object owned by native code (e.g. member returned by reference).
+ * Wrapper has no finalizer and keeps `this` of the running native call (parent wrapper) alive.
+ * Children of borrowed wrappers are invalidated together with the borrow scope of their parent.
+ */
+template <class T>
+inline void PushReferenceObject(duk::Context &d, T *obj) {
+    typedef typename std::remove_cv<T>::type TC;
+
+    if (!obj) {
+        duk_push_null(d);
+        return;
+    }
 
-    duk_get_prop_string(d, objIdx, "\xff" "obj_ptr");
-    T *obj = reinterpret_cast<T*>(duk_get_pointer(d, -1));
-    duk_pop(d);
+    duk_push_object(d);
 
-    assert(obj);
+    NativeRef ref = PushMostDerivedPrototype(d, const_cast<TC*>(obj));
+    duk_set_prototype(d, -2);
+
+    PutNativeRef(d, -1, ref);
+
+    duk_push_this(d);
+
+    // parent is valid while the method runs, so the scope owning it is still active
+    Context::BorrowScope *scope = nullptr;
+    if (duk_is_object(d, -1)) {
+        details::GetHiddenProp(d, -1, details::HiddenKey::Borrowed);
+        scope = static_cast<Context::BorrowScope*>(duk_get_pointer(d, -1));
+        duk_pop(d);
+    }
+
+    details::PutHiddenProp(d, -2, details::HiddenKey::Parent);
+
+    if (scope) {
+        duk_push_pointer(d, scope);
+        details::PutHiddenProp(d, -2, details::HiddenKey::Borrowed);
+        scope->track(-1);
+    }
+}
+
+}
+
+template <class T, class Enable>
+inline void Type<T, Enable>::push(duk::Context &d, T const &value) {
+    static_assert(std::is_copy_constructible<T>::value,
+                  "object pushed by value must be copy constructible, push it with duk::Borrow or std::shared_ptr");
+
+    details::PushValueObject(d, value);
+}
+
+template <class T, class Enable>
+inline void Type<T, Enable>::push(duk::Context &d, T &&value) {
+    details::PushValueObject(d, std::move(value));
+}
+
+template <class T, class Enable>
+inline void Type<T, Enable>::get(duk::Context &d, T &value, int objIdx) {
+    static_assert(std::is_copy_constructible<T>::value, "object must be copy constructible");
 
-    value = *obj;
+    value = *details::GetNativeObject<T>(d, objIdx);
 }
 
 }
@@ -0,0 +1,392 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <typeindex>
+#include <typeinfo>
+#include <utility>
+
+#include <duktape.h>
+
+#include "./Utils/ClassInfo.h"
+#include "./Utils/Helpers.h"
+#include "./Utils/Inspect.h"
+
+#include "BindingPlan.h"
+#include "BindingStats.h"
+#include "Constructor.h"
+#include "Context.inl"
+#include "EmptyInspector.h"
+#include "LightFunc.h"
+#include "MagicTable.h"
+#include "Method.h"
+#include "Overloads.h"
+#include "Prototype.h"
+#include "Tracer.h"
+
+namespace duk {
+
+namespace details {
+
+/**
+ * Record function calling `method` from `MagicTable` (see `Method::tableFunc`), not set if table is full
+ */
+template <class C, class R, class ... A, class M>
+inline PlanFunction TableMemberFunction(M method, const char *className, const char *prefix, const char *name) {
+    PlanFunction f;
+    int magic = MagicTable<M>::add(method);
+    if (magic >= 0) {
+        f.func = &Method<C, R, A...>::template tableFunc<M, MagicTable<M>>;
+        f.nargs = duk_idx_t(sizeof...(A));
+        f.magic = magic;
+        f.stats = FindBindingStats(className, prefix, name);
+        f.traceName = TraceName(className, prefix, name);
+    }
+    return f;
+}
+
+template <class C, class R, class ... A>
+inline PlanFunction TableMethod(R (C::*method)(A...), const char *prefix, const char *name) {
+    return TableMemberFunction<C, R, A...>(method, ClassName<C>::value, prefix, name);
+}
+
+template <class C, class R, class ... A>
+inline PlanFunction TableMethod(R (C::*method)(A...) const, const char *prefix, const char *name) {
+    return TableMemberFunction<C, R, A...>(method, ClassName<C>::value, prefix, name);
+}
+
+/**
+ * Record function calling static function or constructor `f` from `MagicTable`
+ * (`Binding::tableFunc` reads it), not set if table is full
+ */
+template <class Binding, class F>
+inline PlanFunction TableFunction(F f, duk_idx_t nargs, BindingStatsRecord *stats, const char *traceName) {
+    PlanFunction res;
+    int magic = MagicTable<F>::add(f);
+    if (magic >= 0) {
+        res.func = &Binding::tableFunc;
+        res.nargs = nargs;
+        res.magic = magic;
+        res.stats = stats;
+        res.traceName = traceName;
+    }
+    return res;
+}
+
+template <class T>
+inline void PushLightFunc(duk::Context &d, std::size_t index) {
+    LightFuncTable<T>::push(d, index);
+}
+
+template <class V>
+inline void PushTableConstant(duk::Context &d, std::size_t index) {
+    Type<V>::push(d, MagicTable<V>::get(int(index)));
+}
+
+/**
+ * Records members declared by T as steps of its prototype plan (see `PushObjectInspector`)
+ */
+template <class T>
+class PrototypePlanInspector: public EmptyInspector {
+public:
+    explicit PrototypePlanInspector(std::vector<PlanStep> &steps): _steps(steps) {}
+
+    template <class C, class A>
+    void property(const char *name, Getter<C, A> getter, Setter<C, A> setter) {
+        PlanStep step = makeStep(name, DUK_DEFPROP_HAVE_GETTER | DUK_DEFPROP_HAVE_SETTER);
+        step.value = bindMethod(getter, "get ", name);
+        step.setter = bindMethod(setter, "set ", name);
+
+        if (!step.value.isSet() || !step.setter.isSet()) {
+            auto pushGetter = pushMethod(getter, "get ", name);
+            auto pushSetter = pushMethod(setter, "set ", name);
+            step.push = [pushGetter, pushSetter] (duk::Context &d) {
+                pushGetter(d);
+                pushSetter(d);
+            };
+        }
+        _steps.push_back(std::move(step));
+    }
+
+    template <class C, class A>
+    void property(const char *name, Getter<C, A> getter) {
+        PlanStep step = makeStep(name, DUK_DEFPROP_HAVE_GETTER);
+        step.value = bindMethod(getter, "get ", name);
+
+        if (!step.value.isSet()) {
+            step.push = pushMethod(getter, "get ", name);
+        }
+        _steps.push_back(std::move(step));
+    }
+
+    template <class C, class R, class ... A>
+    void method(const char *name, R(C::*method)(A...)) {
+        addMethod(name, method);
+    }
+
+    template <class C, class R, class ... A>
+    void method(const char *name, R(C::*method)(A...) const) {
+        addMethod(name, method);
+    }
+
+    template <class M1, class M2, class ... M>
+    void method(const char *name, M1 method1, M2 method2, M ... methods) {
+        const char *className = ClassName<typename MethodTraits<M1>::Class>::value;
+        BindingStatsRecord *rec = FindBindingStats(className, "", name);
+        const char *traceName = TraceName(className, "", name);
+        auto push = std::bind(&MethodOverloads<M1, M2, M...>::push, std::placeholders::_1, method1, method2, methods...);
+
+        PlanStep step = makeStep(name, ValueFlags);
+        step.push = [push, rec, traceName] (duk::Context &d) {
+            push(d);
+            AttachBindingStatsRecord(d, -1, rec);
+            AttachTraceName(d, -1, traceName);
+        };
+        _steps.push_back(std::move(step));
+    }
+
+    template <class C, class R, class ... A>
+    void asyncMethod(const char *name, R(C::*method)(A...)) {
+        addAsync(name, method, ClassName<C>::value);
+    }
+
+    template <class C, class R, class ... A>
+    void asyncMethod(const char *name, R(C::*method)(A...) const) {
+        addAsync(name, method, ClassName<C>::value);
+    }
+
+private:
+    static constexpr duk_uint_t ValueFlags =
+        DUK_DEFPROP_HAVE_VALUE | DUK_DEFPROP_SET_WRITABLE | DUK_DEFPROP_SET_ENUMERABLE | DUK_DEFPROP_SET_CONFIGURABLE;
+
+    std::vector<PlanStep> &_steps;
+    std::size_t _lightFuncIndex = 0;
+
+    static PlanStep makeStep(const char *name, duk_uint_t flags) {
+        PlanStep step;
+        step.name = name;
+        step.flags = flags;
+        return step;
+    }
+
+    template <class M>
+    void addMethod(const char *name, M method) {
+        PlanStep step = makeStep(name, ValueFlags);
+        step.value = bindMethod(method, "", name);
+
+        if (!step.value.isSet()) {
+            step.push = pushMethod(method, "", name);
+        }
+        _steps.push_back(std::move(step));
+    }
+
+    template <class M>
+    void addAsync(const char *name, M method, const char *className) {
+        BindingStatsRecord *rec = FindBindingStats(className, "", name);
+        const char *traceName = TraceName(className, "", name);
+
+        PlanStep step = makeStep(name, ValueFlags);
+        step.push = [method, rec, traceName] (duk::Context &d) {
+            PushAsyncMethod(d, method);
+            AttachBindingStatsRecord(d, -1, rec);
+            AttachTraceName(d, -1, traceName);
+        };
+        _steps.push_back(std::move(step));
+    }
+
+    /**
+     * Pusher of method or accessor which doesn't fit into `MagicTable`
+     */
+    template <class M>
+    static std::function<void(duk::Context &d)> pushMethod(M method, const char *prefix, const char *name) {
+        const char *className = ClassName<typename MethodTraits<M>::Class>::value;
+        BindingStatsRecord *rec = FindBindingStats(className, prefix, name);
+        const char *traceName = TraceName(className, prefix, name);
+
+        return [method, rec, traceName] (duk::Context &d) {
+            PushMethod(d, method);
+            AttachBindingStatsRecord(d, -1, rec);
+            AttachTraceName(d, -1, traceName);
+        };
+    }
+
+    /**
+     * Function of method or accessor, lightfunc classes take the next entry of their table
+     */
+    template <class M>
+    PlanFunction bindMethod(M method, const char *prefix, const char *name) {
+        if (UsesLightFuncs<T>::value()) {
+            PlanFunction f;
+            f.pushIndexed = &PushLightFunc<T>;
+            f.magic = duk_int_t(_lightFuncIndex++);
+            return f;
+        }
+
+        return TableMethod(method, prefix, name);
+    }
+};
+
+/**
+ * Records constructor, constants and static methods of T (see `PushConstructorInspector`
+ * and `ConstantsInspector`)
+ */
+template <class T>
+class StaticsPlanInspector: public EmptyInspector {
+public:
+    explicit StaticsPlanInspector(ClassPlan &plan): _plan(plan) {}
+
+    template <class C, class ... A>
+    void construct(std::shared_ptr<C> (*constructor) (A...)) {
+        if (!_plan.hasConstructor()) {
+            addConstructor<Constructor<C, A...>>(constructor, duk_idx_t(sizeof...(A)));
+        }
+    }
+
+    template <class C, class ... A>
+    void construct(std::unique_ptr<C> (*constructor) (A...)) {
+        if (!_plan.hasConstructor()) {
+            addConstructor<ConstructorUnique<C, A...>>(constructor, duk_idx_t(sizeof...(A)));
+        }
+    }
+
+    template <class F1, class F2, class ... F>
+    void construct(F1 constructor1, F2 constructor2, F ... constructors) {
+        if (!_plan.hasConstructor()) {
+            _plan.pushConstructor = std::bind(&ConstructorOverloads<F1, F2, F...>::push, std::placeholders::_1,
+                                              constructor1, constructor2, constructors...);
+        }
+    }
+
+    template <typename V>
+    void constant(const char *name, V value) {
+        PlanStep step = makeStep(name);
+
+        int index = MagicTable<V>::add(value);
+        if (index >= 0) {
+            step.value.pushIndexed = &PushTableConstant<V>;
+            step.value.magic = index;
+        }
+        else {
+            step.push = [value] (duk::Context &d) { Type<V>::push(d, value); };
+        }
+        _plan.statics.push_back(std::move(step));
+    }
+
+    template <class R, class ... A>
+    void staticMethod(const char *name, R(*func)(A...)) {
+        BindingStatsRecord *rec = FindBindingStats(ClassName<T>::value, "", name);
+        const char *traceName = TraceName(ClassName<T>::value, "", name);
+
+        PlanStep step = makeStep(name);
+        step.value = TableFunction<StaticFunction<R, A...>>(func, duk_idx_t(sizeof...(A)), rec, traceName);
+
+        if (!step.value.isSet()) {
+            step.push = [func, rec, traceName] (duk::Context &d) {
+                StaticFunction<R, A...>::push(d, func);
+                AttachBindingStatsRecord(d, -1, rec);
+                AttachTraceName(d, -1, traceName);
+            };
+        }
+        _plan.statics.push_back(std::move(step));
+    }
+
+private:
+    ClassPlan &_plan;
+
+    static PlanStep makeStep(const char *name) {
+        PlanStep step;
+        step.name = name;
+        step.flags = DUK_DEFPROP_HAVE_VALUE | DUK_DEFPROP_HAVE_WRITABLE | DUK_DEFPROP_HAVE_CONFIGURABLE | DUK_DEFPROP_SET_ENUMERABLE;
+        return step;
+    }
+
+    template <class Binding, class F>
+    void addConstructor(F constructor, duk_idx_t nargs) {
+        _plan.constructor = TableFunction<Binding>(constructor, nargs,
+                                                   FindBindingStats(ClassName<T>::value, "", "constructor"), nullptr);
+        if (!_plan.constructor.isSet()) {
+            _plan.pushConstructor = [constructor] (duk::Context &d) { Binding::push(d, constructor); };
+        }
+    }
+};
+
+template <class T>
+inline std::unique_ptr<ClassPlan> MakeClassPlan() {
+    typedef ClassPath<T> Path;
+
+    std::unique_ptr<ClassPlan> plan(new ClassPlan(std::type_index(typeid(T))));
+    plan->nativeType = NativeTypeOf<T>::get();
+
+    for (std::size_t i = 0; i < Path::size; ++i) {
+        plan->path.emplace_back(Path::data(i), Path::length(i));
+    }
+
+    StaticsPlanInspector<T> statics(*plan);
+    Inspect<T>::inspect(statics);
+
+    PrototypePlanInspector<T> prototype(plan->prototype);
+    InspectOwn<T>::inspect(prototype);
+
+    plan->pushPrototype = &PushPrototype<T>;
+    plan->lazyGet = &LazyClass<T>::get;
+    plan->lazySet = &LazyClass<T>::set;
+    plan->registerPrototype = &LazyClass<T>::registerPrototype;
+
+    return plan;
+}
+
+}
+
+/**
+ * @brief Process-wide registry of classes bound to every context created with
+ *        `ContextOptions::registeredTypes`
+ * @details Each class is inspected once, when it is registered, into a binding plan
+ *          (property names, flags and trampolines with indices of bound members in process-wide
+ *          tables, see `MagicTable`). Contexts define
+ *          registered classes by replaying their plans, `registerClass` and prototypes
+ *          of registered classes use the plans too. Classes are registered in order,
+ *          so register base classes before derived ones if needed for namespaces.
+ *          Register classes before contexts using them are created.
+ */
+class TypeRegistry {
+public:
+    /**
+     * @brief Register class T (class must have `inspect` method), repeated calls have no effect
+     */
+    template <class T>
+    static void Register() {
+        static const bool registered = add<T>();
+        (void)registered;
+    }
+
+    /**
+     * @brief Check if class T is registered
+     */
+    template <class T>
+    static bool IsRegistered() { return details::ClassPlanOf<T>::get() != nullptr; }
+
+private:
+    template <class T>
+    static bool add() {
+        std::unique_ptr<details::ClassPlan> plan = details::MakeClassPlan<T>();
+        details::ClassPlanOf<T>::slot().store(plan.get(), std::memory_order_release);
+        details::ClassPlans::Instance().add(std::move(plan));
+        return true;
+    }
+};
+
+}
+
+#define DUK_CPP_REGISTRY_CONCAT_IMPL(a, b) a##b
+#define DUK_CPP_REGISTRY_CONCAT(a, b) DUK_CPP_REGISTRY_CONCAT_IMPL(a, b)
+
+/**
+ * @brief Registers class T in `TypeRegistry` during static initialization
+ * @details Use at namespace scope after the class name is defined (see `DUK_CPP_DEF_CLASS_NAME`)
+ */
+#define DUK_CPP_REGISTER_CLASS(T) \
+    namespace { \
+    const bool DUK_CPP_REGISTRY_CONCAT(duk_cpp_registered_, __LINE__) = \
+        (duk::TypeRegistry::Register<T>(), true); \
+    }
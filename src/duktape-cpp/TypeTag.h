@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <type_traits>
+
+#include <duktape.h>
+
+#include "./Utils/Helpers.h"
+
+namespace duk { namespace details {
+
+/**
+ * Mask of javascript types accepted for value of type T (specialized for
+ * optional and variant types). Values of other types accept anything.
+ */
+template <class T>
+struct TypeTagOf {
+    static constexpr duk_uint_t AnyType = 0xffffu & ~(duk_uint_t) DUK_TYPE_MASK_NONE;
+
+    static constexpr duk_uint_t value =
+        std::is_same<T, bool>::value ? DUK_TYPE_MASK_BOOLEAN :
+        (std::is_same<T, char>::value || std::is_same<T, char16_t>::value) ? DUK_TYPE_MASK_STRING :
+        (std::is_arithmetic<T>::value || std::is_enum<T>::value) ? DUK_TYPE_MASK_NUMBER :
+        (std::is_same<T, std::string>::value || std::is_same<T, const char *>::value) ? DUK_TYPE_MASK_STRING :
+        AnyType;
+};
+
+/**
+ * Mask of javascript types accepted for argument of type A.
+ * Arguments of other types accept any value, so overloads which differ only
+ * in such arguments are resolved by registration order.
+ */
+template <class A>
+struct ArgTypeTag {
+    static constexpr duk_uint_t value = TypeTagOf<ClearType<A>>::value;
+};
+
+/**
+ * Indicates that argument of type T can be omitted (see `std::optional` support)
+ */
+template <class T>
+struct IsOptionalType {
+    static constexpr bool value = false;
+};
+
+template <class A>
+struct ArgIsOptional {
+    static constexpr bool value = IsOptionalType<ClearType<A>>::value;
+};
+
+}}
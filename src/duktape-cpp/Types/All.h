@@ -6,4 +6,7 @@
 #include "STL.h"
 #include "Function.h"
 #include "Tuples.h"
+#include "Future.h"
+#include "Borrowed.h"
+#include "Optional.h"
 #include "../Type.inl"
\ No newline at end of file
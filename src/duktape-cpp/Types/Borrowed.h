@@ -0,0 +1,79 @@
+#pragma once
+
+#include "../Context.h"
+#include "../Exceptions.h"
+#include "../Type.h"
+#include "../Prototype.h"
+
+namespace duk {
+
+/**
+ * @brief Native object borrowed by scripts for the lifetime of `Context::BorrowScope`
+ * @details Wrapper of borrowed object has no finalizer and no Box, methods and properties
+ *          are inherited from prototype shared by all wrappers of the class.
+ *          When the scope ends, wrappers are invalidated and using them raises TypeError.
+ *          Pushing borrowed object outside of the scope throws `DuktapeException`
+ *          (TypeError when returned from a native method).
+ */
+template <class T>
+class Borrowed {
+public:
+    Borrowed() = default;
+    explicit Borrowed(T &obj) : _ptr(&obj) {}
+
+    T * get() const { return _ptr; }
+    T & operator * () const { return *_ptr; }
+    T * operator -> () const { return _ptr; }
+
+private:
+    T *_ptr = nullptr;
+};
+
+/**
+ * @brief Borrow object to scripts (see `Borrowed`)
+ */
+template <class T>
+inline Borrowed<T> Borrow(T &obj) {
+    return Borrowed<T>(obj);
+}
+
+template <class T>
+struct Type<Borrowed<T>> {
+    static void push(duk::Context &d, Borrowed<T> const &value) {
+        Context::BorrowScope *scope = d.borrowScope();
+        if (!scope) {
+            static const char *message = "Borrowed object can be pushed only inside of duk::Context::BorrowScope";
+
+            // error raised by native call becomes script TypeError, host code has no protected call to catch it
+            duk_push_current_function(d);
+            bool inCall = !duk_is_undefined(d, -1);
+            duk_pop(d);
+
+            if (!inCall) {
+                throw DuktapeException(message);
+            }
+            duk_error(d, DUK_ERR_TYPE_ERROR, "%s", message);
+        }
+
+        duk_push_object(d);
+
+        details::NativeRef ref = details::PushMostDerivedPrototype(d, value.get());
+        duk_set_prototype(d, -2);
+
+        details::PutNativeRef(d, -1, ref);
+
+        // scope owning the wrapper, references returned by its methods are tracked by the same scope
+        duk_push_pointer(d, scope);
+        details::PutHiddenProp(d, -2, details::HiddenKey::Borrowed);
+
+        scope->track(-1);
+    }
+
+    static void get(duk::Context &d, Borrowed<T> &value, int index) {
+        value = Borrowed<T>(*details::GetNativeObject<T>(d, index));
+    }
+
+    static constexpr bool isPrimitive() { return true; };
+};
+
+}
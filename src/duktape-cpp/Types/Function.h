@@ -3,10 +3,12 @@
 #include <functional>
 #include <cassert>
 #include <cstdio>
+#include <string>
 
 #include "../Context.h"
 #include "../Type.h"
 #include "../Exceptions.h"
+#include "../Tracer.h"
 
 namespace duk { namespace details {
 
@@ -29,6 +31,45 @@ struct JSFunctionReturnVal<void> {
     }
 };
 
+/**
+ * Push call arguments
+ */
+inline void PushArgs(Context &d) {
+    // Do nothing
+}
+
+template <typename A1, typename ... AA>
+inline void PushArgs(Context &d, A1 &&a, AA && ... args) {
+    Type<ClearType<A1>>::push(d, std::forward<A1>(a));
+    PushArgs(d, std::forward<AA>(args)...);
+}
+
+/**
+ * Pop error at the stack top and get its message (with stack trace if it's Error)
+ */
+inline std::string PopCallError(Context &d) {
+    // any value can be thrown, reading property of null or undefined would raise another error
+    std::string trace;
+    if (duk_is_error(d, -1)) {
+        duk_get_prop_string(d, -1, "stack");
+        const char *stack = duk_get_string(d, -1);
+        trace = stack ? std::string("\n") + stack : std::string();
+        duk_pop(d);
+    }
+
+    std::string error = duk_safe_to_string(d, -1) + trace;
+    duk_pop(d);
+
+    return error;
+}
+
+/**
+ * Throw error at the stack top as `ScriptEvaluationExcepton`
+ */
+[[noreturn]] inline void ThrowCallError(Context &d) {
+    throw ScriptEvaluationExcepton(PopCallError(d));
+}
+
 }
 
 template <class R, class ... A>
@@ -95,15 +136,15 @@ public:
         assert(_refKey >= 0);
 
         Context &d = Context::GetSelfFromContext(_d);
-        d.getRef(_refKey); 
+        Context::ThreadScope scope(d, d.current());
+        details::TraceScope trace("JSFunction::call", "call");
+        d.getRef(_refKey);
 
         pushArgs(d, std::forward<A>(args)...);
         duk_int_t callRes = duk_pcall(d, sizeof...(args));
+        scope.restore();
         if (callRes != DUK_EXEC_SUCCESS) {
-            duk_get_prop_string(d, -1, "stack");
-            std::string stack = duk_get_string(d, -1);
-            duk_pop(d);
-            throw ScriptEvaluationExcepton(std::string(duk_safe_to_string(d, -1)) + "\n" + stack);
+            details::ThrowCallError(d);
         }
         return details::JSFunctionReturnVal<R>::get(d, 0);
     }
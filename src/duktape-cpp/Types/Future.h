@@ -0,0 +1,61 @@
+#pragma once
+
+#include <future>
+#include <memory>
+
+#include "../Context.h"
+#include "../Type.h"
+#include "../EventLoop.h"
+
+namespace duk {
+
+/**
+ * Future is pushed as thenable object, resolved by context's event loop
+ */
+template <class R>
+struct Type<std::future<R>> {
+    static void push(duk::Context &d, std::future<R> value) {
+        EventLoop *loop = EventLoop::GetFromContext(d);
+        if (!loop) {
+            value = std::future<R>();
+            duk_error(d, DUK_ERR_ERROR, "Async methods require duk::EventLoop");
+        }
+
+        loop->pushFuture(std::move(value));
+    }
+
+    static void get(duk::Context &d, std::future<R> &value, int index) {
+        static_assert(sizeof(R) == 0, "Get std::future from duktape stack is not supported");
+    }
+
+    static constexpr bool isPrimitive() { return true; };
+};
+
+/**
+ * Task is run on the thread pool of context's event loop
+ * and pushed as thenable object resolved with its result.
+ * Receiver of the method call returning the task (see `PushAsyncMethod`)
+ * is kept alive until the task is settled.
+ */
+template <class R>
+struct Type<std::packaged_task<R()>> {
+    static void push(duk::Context &d, std::packaged_task<R()> value) {
+        EventLoop *loop = EventLoop::GetFromContext(d);
+        if (!loop) {
+            value = std::packaged_task<R()>();
+            duk_error(d, DUK_ERR_ERROR, "Async methods require duk::EventLoop");
+        }
+
+        duk_push_this(d);
+        loop->pushTask(std::move(value), -1);
+        duk_remove(d, -2);
+    }
+
+    static void get(duk::Context &d, std::packaged_task<R()> &value, int index) {
+        static_assert(sizeof(R) == 0, "Get std::packaged_task from duktape stack is not supported");
+    }
+
+    static constexpr bool isPrimitive() { return true; };
+};
+
+}
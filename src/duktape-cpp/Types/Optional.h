@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+#include <duktape.h>
+
+#include "../Context.h"
+#include "../Type.h"
+#include "../TypeTag.h"
+
+#if __cplusplus >= 201703L
+#include <optional>
+#include <variant>
+#define DUK_CPP_HAS_OPTIONAL 1
+#else
+#define DUK_CPP_HAS_OPTIONAL 0
+#endif
+
+#if DUK_CPP_HAS_OPTIONAL
+
+namespace duk {
+
+namespace details {
+
+template <class T>
+struct TypeTagOf<std::optional<T>> {
+    static constexpr duk_uint_t value = TypeTagOf<T>::value | DUK_TYPE_MASK_UNDEFINED | DUK_TYPE_MASK_NULL;
+};
+
+template <class T>
+struct IsOptionalType<std::optional<T>> {
+    static constexpr bool value = true;
+};
+
+template <>
+struct TypeTagOf<std::monostate> {
+    static constexpr duk_uint_t value = DUK_TYPE_MASK_NONE | DUK_TYPE_MASK_UNDEFINED | DUK_TYPE_MASK_NULL;
+};
+
+template <class ... A>
+struct TypeTagOf<std::variant<A...>> {
+    static constexpr duk_uint_t value = (TypeTagOf<A>::value | ...);
+};
+
+}
+
+/**
+ * Empty optional is pushed as null, undefined and null (and missing trailing arguments) are read as empty
+ */
+template <class T>
+struct Type<std::optional<T>> {
+    static void push(duk::Context &d, std::optional<T> const &value) {
+        if (!value) {
+            duk_push_null(d);
+            return;
+        }
+
+        Type<T>::push(d, *value);
+    }
+
+    static void get(duk::Context &d, std::optional<T> &value, int index) {
+        // omitted arguments are beyond stack top (type none), so no extra probe is needed
+        constexpr duk_uint_t emptyMask = DUK_TYPE_MASK_NONE | DUK_TYPE_MASK_UNDEFINED | DUK_TYPE_MASK_NULL;
+
+        if (duk_get_type_mask(d, index) & emptyMask) {
+            value.reset();
+            return;
+        }
+
+        T v;
+        Type<T>::get(d, v, index);
+        value = std::move(v);
+    }
+
+    static constexpr bool isPrimitive() { return true; };
+};
+
+template <>
+struct Type<std::monostate> {
+    static void push(duk::Context &d, std::monostate) {
+        duk_push_undefined(d);
+    }
+
+    static void get(duk::Context &, std::monostate &, int) {}
+
+    static constexpr bool isPrimitive() { return true; };
+};
+
+/**
+ * Variant is read as the first alternative which accepts javascript type of the value
+ * (see `details::TypeTagOf`), so alternatives should differ in javascript types
+ */
+template <class ... A>
+struct Type<std::variant<A...>> {
+    static void push(duk::Context &d, std::variant<A...> const &value) {
+        if (value.valueless_by_exception()) {
+            duk_push_undefined(d);
+            return;
+        }
+
+        std::visit([&d] (auto const &v) {
+            Type<ClearType<decltype(v)>>::push(d, v);
+        }, value);
+    }
+
+    static void get(duk::Context &d, std::variant<A...> &value, int index) {
+        duk_uint_t mask = duk_get_type_mask(d, index);
+
+        if (!getAlternative(d, value, index, mask, std::index_sequence_for<A...>())) {
+            duk_error(d, DUK_ERR_TYPE_ERROR, "Value doesn't match any alternative of variant");
+        }
+    }
+
+    static constexpr bool isPrimitive() { return true; };
+
+private:
+    template <std::size_t ... I>
+    static bool getAlternative(duk::Context &d, std::variant<A...> &value, int index, duk_uint_t mask,
+                               std::index_sequence<I...>) {
+        return (getAlternative<I>(d, value, index, mask) || ...);
+    }
+
+    template <std::size_t I>
+    static bool getAlternative(duk::Context &d, std::variant<A...> &value, int index, duk_uint_t mask) {
+        typedef std::variant_alternative_t<I, std::variant<A...>> Alt;
+
+        if (!(details::TypeTagOf<Alt>::value & mask)) {
+            return false;
+        }
+
+        Alt v;
+        Type<Alt>::get(d, v, index);
+        value.template emplace<I>(std::move(v));
+        return true;
+    }
+};
+
+}
+
+#endif
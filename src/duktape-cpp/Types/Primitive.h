@@ -1,3 +1,12 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include <duktape.h>
+
 #include "../Type.h"
 
 namespace duk {
@@ -28,6 +37,221 @@ struct Type<unsigned int> {
     static constexpr bool isPrimitive() { return true; };
 };
 
+/**
+ * @brief Conversion of numbers which are not integers or are out of range of integer type
+ */
+enum class RangeCheck {
+    Throw,  ///< RangeError
+    Clamp,  ///< fraction is truncated, value is clamped to the range of the type, NaN is 0
+    Wrap    ///< fraction is truncated, value is taken modulo 2^bits (like ToInt32), NaN and infinities are 0
+};
+
+/**
+ * @brief Range check policy of integer or enum type (see `DUK_CPP_DEF_RANGE_CHECK`)
+ * @details Applies to integer types other than `int` and `unsigned int`,
+ *          which keep duktape coercion (clamping)
+ */
+template <class T>
+struct RangeCheckOf {
+    static constexpr RangeCheck value = RangeCheck::Throw;
+};
+
+namespace details {
+
+/**
+ * Conversion of integer type I. Values fitting into 32 bits are pushed as duktape integers
+ * (fastints if built with DUK_CPP_ENABLE_FASTINT), larger ones as doubles, so 64-bit values
+ * beyond 2^53 lose precision. Integer values are read without conversion to double if possible.
+ */
+template <class I, RangeCheck Policy>
+struct IntegerConverter {
+    typedef typename std::make_unsigned<I>::type U;
+
+    static void push(duk_context *d, I val) {
+        push(d, val, std::is_signed<I>());
+    }
+
+    static I get(duk_context *d, int index) {
+#if defined(DUK_USE_64BIT_OPS)
+        duk_int64_t val;
+        if (duk_cpp_get_int64(d, index, &val) && inRange(val, std::is_signed<I>())) {
+            return I(val);
+        }
+#endif
+        return convert(d, duk_require_number(d, index), std::integral_constant<RangeCheck, Policy>());
+    }
+
+private:
+    static constexpr int Bits = std::numeric_limits<U>::digits;
+
+    static void push(duk_context *d, I val, std::true_type) {
+        long long v = val;
+        if (v >= std::numeric_limits<duk_int_t>::min() && v <= std::numeric_limits<duk_int_t>::max()) {
+            duk_push_int(d, duk_int_t(v));
+        }
+        else {
+            duk_push_number(d, duk_double_t(v));
+        }
+    }
+
+    static void push(duk_context *d, I val, std::false_type) {
+        unsigned long long v = val;
+        if (v <= std::numeric_limits<duk_uint_t>::max()) {
+            duk_push_uint(d, duk_uint_t(v));
+        }
+        else {
+            duk_push_number(d, duk_double_t(v));
+        }
+    }
+
+#if defined(DUK_USE_64BIT_OPS)
+    static bool inRange(duk_int64_t val, std::true_type) {
+        return val >= std::numeric_limits<I>::min() && val <= std::numeric_limits<I>::max();
+    }
+
+    static bool inRange(duk_int64_t val, std::false_type) {
+        return val >= 0 && static_cast<unsigned long long>(val) <= std::numeric_limits<I>::max();
+    }
+#endif
+
+    /**
+     * Range of I as doubles: [lower, upperExcl), both bounds are powers of two, so they are exact
+     */
+    static double lower() { return std::is_signed<I>::value ? -std::ldexp(1.0, Bits - 1) : 0.0; }
+    static double upperExcl() { return std::ldexp(1.0, std::numeric_limits<I>::digits); }
+
+    static I convert(duk_context *d, double n, std::integral_constant<RangeCheck, RangeCheck::Throw>) {
+        if (!(n >= lower() && n < upperExcl()) || std::trunc(n) != n) {
+            duk_error(d, DUK_ERR_RANGE_ERROR, "%g is not an integer in range of the native type", n);
+        }
+        return I(n);
+    }
+
+    static I convert(duk_context *, double n, std::integral_constant<RangeCheck, RangeCheck::Clamp>) {
+        if (std::isnan(n)) {
+            return I(0);
+        }
+        if (n < lower()) {
+            return std::numeric_limits<I>::min();
+        }
+        if (n >= upperExcl()) {
+            return std::numeric_limits<I>::max();
+        }
+        return I(std::trunc(n));
+    }
+
+    static I convert(duk_context *, double n, std::integral_constant<RangeCheck, RangeCheck::Wrap>) {
+        if (!std::isfinite(n)) {
+            return I(0);
+        }
+
+        double modulo = std::ldexp(1.0, Bits);
+        double m = std::fmod(std::trunc(n), modulo);
+        if (m < 0) {
+            m += modulo;
+        }
+        if (m >= modulo) {
+            m = 0;
+        }
+        return I(U(m));
+    }
+};
+
+template <class T>
+struct IntegerType {
+    typedef IntegerConverter<T, RangeCheckOf<T>::value> Converter;
+
+    static void push(duk::Context &d, T val) {
+        Converter::push(d, val);
+    }
+
+    static void get(duk::Context &d, T &val, int index) {
+        val = Converter::get(d, index);
+    }
+
+    static constexpr bool isPrimitive() { return true; };
+};
+
+/**
+ * Characters are converted to/from strings of length 1, T is a code unit (byte for `char`)
+ */
+template <class T>
+struct CharType {
+    typedef typename std::make_unsigned<T>::type U;
+
+    static void push(duk::Context &d, T val) {
+        duk_uint_t c = U(val);
+        char buf[3];
+        duk_size_t len = 0;
+
+        // code unit is encoded as in duktape strings (CESU-8)
+        if (c < 0x80) {
+            buf[len++] = char(c);
+        }
+        else if (c < 0x800) {
+            buf[len++] = char(0xc0 | (c >> 6));
+            buf[len++] = char(0x80 | (c & 0x3f));
+        }
+        else {
+            buf[len++] = char(0xe0 | (c >> 12));
+            buf[len++] = char(0x80 | ((c >> 6) & 0x3f));
+            buf[len++] = char(0x80 | (c & 0x3f));
+        }
+
+        duk_push_lstring(d, buf, len);
+    }
+
+    static void get(duk::Context &d, T &val, int index) {
+        duk_require_string(d, index);
+
+        if (duk_get_length(d, index) != 1) {
+            duk_error(d, DUK_ERR_RANGE_ERROR, "Expected string of length 1");
+        }
+
+        duk_codepoint_t c = duk_char_code_at(d, index, 0);
+        if (c < 0 || duk_uint_t(c) > std::numeric_limits<U>::max()) {
+            duk_error(d, DUK_ERR_RANGE_ERROR, "Character is out of range of the native type");
+        }
+
+        val = T(U(c));
+    }
+
+    static constexpr bool isPrimitive() { return true; };
+};
+
+}
+
+template <> struct Type<signed char>: details::IntegerType<signed char> {};
+template <> struct Type<unsigned char>: details::IntegerType<unsigned char> {};
+template <> struct Type<short>: details::IntegerType<short> {};
+template <> struct Type<unsigned short>: details::IntegerType<unsigned short> {};
+template <> struct Type<long>: details::IntegerType<long> {};
+template <> struct Type<unsigned long>: details::IntegerType<unsigned long> {};
+template <> struct Type<long long>: details::IntegerType<long long> {};
+template <> struct Type<unsigned long long>: details::IntegerType<unsigned long long> {};
+
+template <> struct Type<char>: details::CharType<char> {};
+template <> struct Type<char16_t>: details::CharType<char16_t> {};
+
+/**
+ * Enums are converted as their underlying integer type
+ */
+template <class T>
+struct Type<T, typename std::enable_if<std::is_enum<T>::value>::type> {
+    typedef typename std::underlying_type<T>::type I;
+    typedef details::IntegerConverter<I, RangeCheckOf<T>::value> Converter;
+
+    static void push(duk::Context &d, T val) {
+        Converter::push(d, I(val));
+    }
+
+    static void get(duk::Context &d, T &val, int index) {
+        val = T(Converter::get(d, index));
+    }
+
+    static constexpr bool isPrimitive() { return true; };
+};
+
 template <>
 struct Type<float> {
     static void push(duk::Context &d, float val) {
@@ -67,4 +291,53 @@ struct Type<bool> {
     static constexpr bool isPrimitive() { return true; };
 };
 
+namespace details {
+
+template <>
+struct UncheckedType<int>: Type<int> {
+    static void get(duk::Context &d, int &val, int index) {
+        val = duk_get_int(d, index);
+    }
+};
+
+template <>
+struct UncheckedType<unsigned int>: Type<unsigned int> {
+    static void get(duk::Context &d, unsigned int &val, int index) {
+        val = duk_get_uint(d, index);
+    }
+};
+
+template <>
+struct UncheckedType<float>: Type<float> {
+    static void get(duk::Context &d, float &val, int index) {
+        val = float(duk_get_number(d, index));
+    }
+};
+
+template <>
+struct UncheckedType<double>: Type<double> {
+    static void get(duk::Context &d, double &val, int index) {
+        val = duk_get_number(d, index);
+    }
+};
+
+template <>
+struct UncheckedType<bool>: Type<bool> {
+    static void get(duk::Context &d, bool &val, int index) {
+        val = bool(duk_get_boolean(d, index));
+    }
+};
+
 }
+
+}
+
+/**
+ * @brief Defines range check policy of integer or enum type (see `RangeCheck`)
+ */
+#define DUK_CPP_DEF_RANGE_CHECK(T, policy) \
+    namespace duk { \
+    template <> \
+    struct RangeCheckOf<T> { \
+        static constexpr RangeCheck value = policy; \
+    };}
@@ -6,11 +6,12 @@
 #include "../Utils/Helpers.h"
 #include "../Utils/Inspect.h"
 
-#include "../PushObjectInspector.h"
+#include "../Prototype.h"
 
 #include "../Box.h"
 #include "../Type.h"
 #include "../Context.h"
+#include "../Tracer.h"
 
 namespace duk {
 
@@ -25,11 +26,11 @@ struct SptrBox {
 template <class T>
 struct SptrBox<T, true> {
     static std::unique_ptr<BoxBase> make(std::shared_ptr<T> const &value) {
-        return std::make_unique<Box<std::shared_ptr<typename BaseClass<T>::type>>>(value);
+        return std::make_unique<Box<std::shared_ptr<RootBaseOf<T>>>>(value);
     }
 
     static void assign(BoxBase const &box, std::shared_ptr<T> &value) {
-        auto const &b = box.as<Box<std::shared_ptr<typename BaseClass<T>::type>>>();
+        auto const &b = box.as<Box<std::shared_ptr<RootBaseOf<T>>>>();
         value = std::dynamic_pointer_cast<T>(b.value());
     }
 };
@@ -55,14 +56,14 @@ struct SptrBox<T, false> {
 template <class T>
 struct Type<std::shared_ptr<T>> {
     static duk_ret_t finalizer(duk_context *d) {
+        details::TraceScope trace(ClassName<T>::value, "finalizer");
+        Context::CountFinalizer(d);
+
         // get pointer to duk::Context
-        duk_push_global_stash(d);
-        duk_get_prop_string(d, -1, "self_ptr");
-        duk::Context *self = reinterpret_cast<duk::Context*>(duk_get_pointer(d, -1));
-        duk_pop_2(d);
+        duk::Context *self = &Context::GetSelfFromContext(d);
 
         // get pointer to shared pointer
-        duk_get_prop_string(d, 0, "\xff" "sptr_key");
+        details::GetHiddenProp(d, 0, details::HiddenKey::SptrKey);
         int boxKey = duk_get_int(d, -1);
         duk_pop(d);
 
@@ -84,16 +85,15 @@ struct Type<std::shared_ptr<T>> {
         auto objIdx = duk_push_object(d);
 
         duk_push_int(d, boxKey);
-        duk_put_prop_string(d, -2, "\xff" "sptr_key");
+        details::PutHiddenProp(d, -2, details::HiddenKey::SptrKey);
+
+        details::NativeRef ref = details::PushMostDerivedPrototype(d, value.get());
+        duk_set_prototype(d, objIdx);
 
-        duk_push_pointer(d, value.get());
-        duk_put_prop_string(d, -2, "\xff" "obj_ptr");
+        details::PutNativeRef(d, objIdx, ref);
 
         duk_push_c_function(d, finalizer, 1);
         duk_set_finalizer(d, -2);
-
-        details::PushObjectInspector i(d, objIdx);
-        Inspect<T>::inspect(i);
     }
 
     static void get(duk::Context &d, std::shared_ptr<T> &value, int index) {
@@ -102,7 +102,7 @@ struct Type<std::shared_ptr<T>> {
             return;
         }
 
-        duk_get_prop_string(d, index, "\xff" "sptr_key");
+        details::GetHiddenProp(d, index, details::HiddenKey::SptrKey);
         int key = duk_get_int(d, -1);
         duk_pop(d);
 
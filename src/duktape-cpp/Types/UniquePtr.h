@@ -7,11 +7,12 @@
 #include "../Utils/Helpers.h"
 #include "../Utils/Inspect.h"
 
-#include "../PushObjectInspector.h"
+#include "../Prototype.h"
 
 #include "../Box.h"
 #include "../Type.h"
 #include "../Context.h"
+#include "../Tracer.h"
 
 
 namespace duk {
@@ -39,16 +40,16 @@ struct MakeUptrBox {
 template <class T>
 struct MakeUptrBox<T, true> {
     static std::unique_ptr<BoxBase> make(std::unique_ptr<T> value) {
-        return std::make_unique<Box<std::unique_ptr<typename BaseClass<T>::type>>>(std::move(value));
+        return std::make_unique<Box<std::unique_ptr<RootBaseOf<T>>>>(std::move(value));
     }
 
     static void assign(BoxBase &box, std::unique_ptr<T> &value) {
-        auto &b = box.as<Box<std::unique_ptr<typename BaseClass<T>::type>>>();
+        auto &b = box.as<Box<std::unique_ptr<RootBaseOf<T>>>>();
 
         assert(b.value());
 
-        std::unique_ptr<typename BaseClass<T>::type> &v = b.value();
-        std::unique_ptr<typename BaseClass<T>::type> bp(std::move(v));
+        std::unique_ptr<RootBaseOf<T>> &v = b.value();
+        std::unique_ptr<RootBaseOf<T>> bp(std::move(v));
         std::unique_ptr<T> cp = dynamic_unique_cast<T>(std::move(bp));
 
         if (cp) {
@@ -76,14 +77,14 @@ struct MakeUptrBox<T, false> {
 template <class T>
 struct Type<std::unique_ptr<T>> {
     static duk_ret_t finalizer(duk_context *d) {
+        details::TraceScope trace(ClassName<T>::value, "finalizer");
+        Context::CountFinalizer(d);
+
         // get pointer to duk::Context
-        duk_push_global_stash(d);
-        duk_get_prop_string(d, -1, "self_ptr");
-        duk::Context *self = reinterpret_cast<duk::Context*>(duk_get_pointer(d, -1));
-        duk_pop_2(d);
+        duk::Context *self = &Context::GetSelfFromContext(d);
 
         // get pointer to shared pointer
-        duk_get_prop_string(d, 0, "\xff" "uptr_key");
+        details::GetHiddenProp(d, 0, details::HiddenKey::UptrKey);
         int boxKey = duk_get_int(d, -1);
         duk_pop(d);
 
@@ -95,7 +96,7 @@ struct Type<std::unique_ptr<T>> {
     static void push(duk::Context &d, std::unique_ptr<T> value) {
         assert(value);
 
-        T * objPtr = value.get();
+        T * rawPtr = value.get();
 
         std::unique_ptr<BoxBase> box = details::MakeUptrBox<T, BaseClass<T>::isDefined()>::make(std::move(value));
 
@@ -104,20 +105,19 @@ struct Type<std::unique_ptr<T>> {
         auto objIdx = duk_push_object(d);
 
         duk_push_int(d, boxKey);
-        duk_put_prop_string(d, -2, "\xff" "uptr_key");
+        details::PutHiddenProp(d, -2, details::HiddenKey::UptrKey);
+
+        details::NativeRef ref = details::PushMostDerivedPrototype(d, rawPtr);
+        duk_set_prototype(d, objIdx);
 
-        duk_push_pointer(d, objPtr);
-        duk_put_prop_string(d, -2, "\xff" "obj_ptr");
+        details::PutNativeRef(d, objIdx, ref);
 
         duk_push_c_function(d, finalizer, 1);
         duk_set_finalizer(d, -2);
-
-        details::PushObjectInspector i(d, objIdx);
-        Inspect<T>::inspect(i);
     }
 
     static void get(duk::Context &d, std::unique_ptr<T> &value, int index) {
-        duk_get_prop_string(d, index, "\xff" "uptr_key");
+        details::GetHiddenProp(d, index, details::HiddenKey::UptrKey);
         int key = duk_get_int(d, -1);
         duk_pop(d);
 
@@ -33,6 +33,21 @@ struct BaseClass {
 
 template <class T> using BaseOf = typename BaseClass<T>::type;
 
+/**
+ * @brief The topmost base class of T (see `BaseClass`), T itself if it has no base
+ */
+template <class T, bool HasBase = BaseClass<T>::isDefined()>
+struct RootBaseClass {
+    using type = T;
+};
+
+template <class T>
+struct RootBaseClass<T, true> {
+    using type = typename RootBaseClass<BaseOf<T>>::type;
+};
+
+template <class T> using RootBaseOf = typename RootBaseClass<T>::type;
+
 template <class T>
 class TypeName {
     const char * typeName() const {
@@ -40,11 +55,33 @@ class TypeName {
     }
 };
 
+/**
+ * @brief Pushed pointers to T are wrapped with the prototype of the most-derived class
+ *        registered in the context (see `DUK_CPP_DEF_POLYMORPHIC`)
+ */
 template <class T>
 struct IsPolymorphic {
     static constexpr bool value() { return false; }
 };
 
+/**
+ * @brief Bindings of T are called by trusted scripts only, so in release builds they skip
+ *        argument type checks, receiver checks and constructor call checks (see `DUK_CPP_DEF_TRUSTED`)
+ */
+template <class T>
+struct IsTrusted {
+    static constexpr bool value() { return false; }
+};
+
+/**
+ * @brief Methods and accessors of T are bound as lightfuncs dispatched through
+ *        a per-class table (see `DUK_CPP_DEF_LIGHTFUNCS`)
+ */
+template <class T>
+struct UsesLightFuncs {
+    static constexpr bool value() { return false; }
+};
+
 }
 
 /**
@@ -77,8 +114,36 @@ struct IsPolymorphic {
         using type = Base; \
     };}
 
+/**
+ * @brief Marks polymorphic class: when pointer to T is pushed, its dynamic type
+ *        is looked up among classes registered with `Context::registerClass`
+ */
 #define DUK_CPP_DEF_POLYMORPHIC(T) \
     namespace duk { \
     template <> struct IsPolymorphic<T> { \
         static constexpr bool value() { return true; } \
     };}
+
+/**
+ * @brief Marks class as trusted: its methods and constructors read arguments with
+ *        non-throwing duk_get_* functions and don't check receiver and `new` call.
+ *        Checks are kept in debug builds (without NDEBUG).
+ *        Calling bindings of trusted class with wrong arguments is undefined behavior.
+ */
+#define DUK_CPP_DEF_TRUSTED(T) \
+    namespace duk { \
+    template <> struct IsTrusted<T> { \
+        static constexpr bool value() { return true; } \
+    };}
+
+/**
+ * @brief Binds methods and property accessors of T as duktape lightfuncs: prototype
+ *        members carry only an index into a table of T's bindings built once per process,
+ *        so they need no function objects, hidden properties and finalizers.
+ *        Overloaded and async methods are bound as usual.
+ */
+#define DUK_CPP_DEF_LIGHTFUNCS(T) \
+    namespace duk { \
+    template <> struct UsesLightFuncs<T> { \
+        static constexpr bool value() { return true; } \
+    };}
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <cstddef>
 #include <type_traits>
 #include <vector>
 #include <string>
-#include <regex>
+
+#include "ClassInfo.h"
 
 namespace duk {
 
@@ -27,10 +29,86 @@ struct HasInspectMethod {
 };
 
 inline std::vector<std::string> splitNamespaces(std::string const &className) {
-    std::regex re("::");
-    std::sregex_token_iterator first { className.begin(), className.end(), re, -1 };
-    std::sregex_token_iterator last;
-    return {first, last};
+    std::vector<std::string> res;
+    std::string::size_type start = 0;
+    std::string::size_type pos;
+    while ((pos = className.find("::", start)) != std::string::npos) {
+        res.push_back(className.substr(start, pos - start));
+        start = pos + 2;
+    }
+    res.push_back(className.substr(start));
+    return res;
+}
+
+namespace details {
+
+/**
+ * Part of qualified name: `length` characters starting at `offset`
+ */
+struct NameSegment {
+    std::size_t offset;
+    std::size_t length;
+};
+
+template <std::size_t N>
+struct NameSegments {
+    NameSegment items[N];
+};
+
+constexpr std::size_t CountNameSegments(const char *name) {
+    std::size_t n = 1;
+    for (std::size_t i = 0; name[i]; ++i) {
+        if (name[i] == ':' && name[i + 1] == ':') {
+            n += 1;
+            i += 1;
+        }
+    }
+    return n;
+}
+
+/**
+ * Split qualified name at "::" (same as `splitNamespaces`, usable at compile time)
+ */
+template <std::size_t N>
+constexpr NameSegments<N> SplitQualifiedName(const char *name) {
+    NameSegments<N> res {};
+    std::size_t seg = 0;
+    std::size_t start = 0;
+    std::size_t i = 0;
+    for (; name[i]; ++i) {
+        if (name[i] == ':' && name[i + 1] == ':') {
+            res.items[seg] = NameSegment { start, i - start };
+            seg += 1;
+            i += 1;
+            start = i + 1;
+        }
+    }
+    res.items[seg] = NameSegment { start, i - start };
+    return res;
+}
+
+/**
+ * Namespaces and name of class T, split at compile time from `ClassName<T>::value`
+ */
+template <class T>
+struct ClassPath {
+    static constexpr const char *name = GetClassName<T>();
+    static constexpr std::size_t size = CountNameSegments(name);
+    static constexpr NameSegments<size> segments = SplitQualifiedName<size>(name);
+
+    static const char * data(std::size_t i) { return name + segments.items[i].offset; }
+    static std::size_t length(std::size_t i) { return segments.items[i].length; }
+};
+
+template <class T>
+constexpr const char *ClassPath<T>::name;
+
+template <class T>
+constexpr std::size_t ClassPath<T>::size;
+
+template <class T>
+constexpr NameSegments<ClassPath<T>::size> ClassPath<T>::segments;
+
 }
 
 }
@@ -28,6 +28,26 @@ struct InspectBase<void> {
     }
 };
 
+/**
+ * Inspect only members declared by T, without members of its base class
+ * (used for prototypes, which inherit base members from prototype of the base class)
+ */
+template <class T, bool HasMethod = HasInspectMethod<T>::value>
+struct InspectOwn {
+    template<class I>
+    static void inspect(I &i) {
+        T::inspect(i);
+    }
+};
+
+template <class T>
+struct InspectOwn<T, false> {
+    template<class I>
+    static void inspect(I &i) {
+        Inspect<T>::inspect(i);
+    }
+};
+
 }
 
 template <class T>
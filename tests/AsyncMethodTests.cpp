@@ -0,0 +1,137 @@
+#include <catch/catch.hpp>
+
+#include <stdexcept>
+#include <thread>
+
+#include <duktape-cpp/DuktapeCpp.h>
+
+namespace AsyncMethodTests {
+
+class Storage {
+public:
+    explicit Storage(duk::ThreadPool &pool) : _pool(pool) {}
+
+    int lookup(int key) const {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        return key * 10;
+    }
+
+    std::string fail() const {
+        throw std::runtime_error("lookup failed");
+    }
+
+    std::future<std::string> load(std::string const &name) {
+        return _pool.submit([name] { return "loaded " + name; });
+    }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.asyncMethod("lookup", &Storage::lookup);
+        i.asyncMethod("fail", &Storage::fail);
+        i.method("load", &Storage::load);
+    }
+
+private:
+    duk::ThreadPool &_pool;
+};
+
+}
+
+DUK_CPP_DEF_CLASS_NAME(AsyncMethodTests::Storage);
+
+TEST_CASE("Async methods", "[duktape]") {
+    using namespace AsyncMethodTests;
+
+    duk::Context d;
+    duk::EventLoop loop(d);
+
+    auto pool = std::make_shared<duk::ThreadPool>(2);
+    loop.setThreadPool(pool);
+
+    d.addGlobal("storage", std::make_shared<Storage>(*pool));
+    d.evalStringNoRes("var log = [];");
+
+    auto getLog = [&d] () {
+        std::string log;
+        d.evalString(log, "log.join(',')");
+        return log;
+    };
+
+    SECTION("should resolve async method result on the loop thread") {
+        d.evalStringNoRes(
+            "storage.lookup(4).then(function (v) { log.push(v); });\n"
+            "log.push('sync');"
+        );
+
+        REQUIRE(getLog() == "sync");
+
+        loop.runUntilIdle();
+
+        REQUIRE(getLog() == "sync,40");
+        REQUIRE(duk_get_top(d) == 0);
+    }
+
+    SECTION("should wake up the loop when async method is done") {
+        d.evalStringNoRes("storage.lookup(4).then(function (v) { log.push(v); });");
+
+        auto start = duk::EventLoop::Clock::now();
+        loop.runOnce(start + std::chrono::seconds(5));
+        auto elapsed = duk::EventLoop::Clock::now() - start;
+
+        REQUIRE(elapsed < std::chrono::seconds(1));
+
+        loop.runUntilIdle();
+        REQUIRE(getLog() == "40");
+    }
+
+    SECTION("should keep receiver alive until result is settled") {
+        auto temp = std::make_shared<Storage>(*pool);
+        std::weak_ptr<Storage> weak = temp;
+        d.addGlobal("temp", temp);
+        temp.reset();
+
+        d.evalStringNoRes(
+            "temp.lookup(2).then(function (v) { log.push(v); });\n"
+            "temp = undefined;"
+        );
+        d.collectGarbage();
+
+        REQUIRE_FALSE(weak.expired());
+
+        loop.runUntilIdle();
+        d.collectGarbage();
+
+        REQUIRE(getLog() == "20");
+        REQUIRE(weak.expired());
+    }
+
+    SECTION("should reject when async method throws") {
+        d.evalStringNoRes(
+            "storage.fail().then(null, function (e) { log.push(e.message); });"
+        );
+
+        loop.runUntilIdle();
+
+        REQUIRE(getLog() == "lookup failed");
+    }
+
+    SECTION("should resolve futures returned from methods") {
+        d.evalStringNoRes(
+            "storage.load('config').then(function (v) { log.push(v); });"
+        );
+
+        loop.runUntilIdle();
+
+        REQUIRE(getLog() == "loaded config");
+    }
+
+    SECTION("should call handlers added after resolution") {
+        d.evalStringNoRes("var p = storage.lookup(1);");
+        loop.runUntilIdle();
+
+        d.evalStringNoRes("p.then(function (v) { log.push(v); });");
+        loop.runUntilIdle();
+
+        REQUIRE(getLog() == "10");
+    }
+}
@@ -0,0 +1,86 @@
+#include <iterator>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <catch/catch.hpp>
+
+#include <duktape-cpp/DuktapeCpp.h>
+
+TEST_CASE("Batch calls", "[duktape]") {
+    duk::Context d;
+    d.evalStringNoRes(
+        "var calls = 0;"
+        "function isEven(x) { calls++; return x % 2 == 0; }"
+        "function label(id, name) { return name + '#' + id; }"
+        "function failAt(x) { if (x == 5) { throw new Error('bad record'); } return x * 10; }"
+    );
+
+    SECTION("should write results of calls to output range") {
+        std::vector<int> records { 1, 2, 3, 4, 6 };
+        std::vector<bool> even;
+
+        duk::FunctionHandle<bool(int)> isEven(d, "isEven");
+        isEven.callEach(records.begin(), records.end(), std::back_inserter(even));
+
+        REQUIRE(even == std::vector<bool>({ false, true, false, true, true }));
+        REQUIRE(duk_get_top(d) == 0);
+    }
+
+    SECTION("should return end of output range") {
+        std::vector<int> records { 1, 2, 3 };
+        int out[5] = { 0, 0, 0, 0, 0 };
+
+        duk::FunctionHandle<int(int)> failAt(d, "failAt");
+        int *end = failAt.callEach(records.begin(), records.end(), out);
+
+        REQUIRE(end == out + 3);
+        REQUIRE(out[2] == 30);
+        REQUIRE(out[3] == 0);
+    }
+
+    SECTION("should unpack tuples of arguments") {
+        std::vector<std::tuple<int, std::string>> records {
+            std::make_tuple(1, "a"), std::make_tuple(2, "b")
+        };
+        std::vector<std::string> labels;
+
+        duk::FunctionHandle<std::string(int, std::string)> label(d, "label");
+        label.callEach(records.begin(), records.end(), std::back_inserter(labels));
+
+        REQUIRE(labels == std::vector<std::string>({ "a#1", "b#2" }));
+    }
+
+    SECTION("should ignore results") {
+        std::vector<int> records(100, 1);
+
+        duk::FunctionHandle<bool(int)> isEven(d, "isEven");
+        isEven.callEach(records.begin(), records.end());
+
+        int calls = 0;
+        d.getGlobal("calls", calls);
+        REQUIRE(calls == 100);
+        REQUIRE(duk_get_top(d) == 0);
+    }
+
+    SECTION("should stop on the first error") {
+        std::vector<int> records { 1, 2, 3, 4, 5, 6, 7 };
+        std::vector<int> out;
+
+        duk::FunctionHandle<int(int)> failAt(d, "failAt");
+
+        bool thrown = false;
+        try {
+            failAt.callEach(records.begin(), records.end(), std::back_inserter(out));
+        }
+        catch (duk::BatchCallError &e) {
+            thrown = true;
+            REQUIRE(e.index() == 4);
+            REQUIRE(std::string(e.what()).find("bad record") != std::string::npos);
+        }
+
+        REQUIRE(thrown);
+        REQUIRE(out == std::vector<int>({ 10, 20, 30, 40 }));
+        REQUIRE(duk_get_top(d) == 0);
+    }
+}
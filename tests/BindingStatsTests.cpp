@@ -0,0 +1,109 @@
+#include <catch/catch.hpp>
+
+#include <duktape-cpp/DuktapeCpp.h>
+
+namespace BindingStatsTests {
+
+class Vec {
+public:
+    Vec() = default;
+
+    static std::shared_ptr<Vec> create() { return std::make_shared<Vec>(); }
+
+    void add(int value) { _x += value; }
+
+    int x() const { return _x; }
+    void setX(int x) { _x = x; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.construct(&Vec::create);
+        i.method("add", &Vec::add);
+        i.property("x", &Vec::x, &Vec::setX);
+    }
+
+private:
+    int _x {0};
+};
+
+}
+
+DUK_CPP_DEF_CLASS_NAME(BindingStatsTests::Vec);
+
+TEST_CASE("Binding stats", "[duktape]") {
+    using namespace BindingStatsTests;
+
+    duk::Context d;
+    d.registerClass<Vec>();
+    duk::BindingStats::Reset();
+
+    d.evalStringNoRes(
+        "var v = new BindingStatsTests.Vec();\n"
+        "for (var i = 0; i < 10; i++) { v.add(i); }\n"
+        "v.x = v.x + 1;"
+    );
+
+    auto find = [] (std::vector<duk::BindingStats> const &stats, std::string const &member) {
+        for (auto const &s : stats) {
+            if (s.className == "BindingStatsTests::Vec" && s.member == member) {
+                return s;
+            }
+        }
+        return duk::BindingStats();
+    };
+
+    if (!duk::BindingStats::IsEnabled()) {
+        SECTION("should not collect stats") {
+            REQUIRE(duk::BindingStats::Snapshot().empty());
+        }
+        return;
+    }
+
+    SECTION("should count calls of methods, accessors and constructors") {
+        auto stats = duk::BindingStats::Snapshot();
+
+        REQUIRE(find(stats, "constructor").calls == 1);
+        REQUIRE(find(stats, "add").calls == 10);
+        REQUIRE(find(stats, "get x").calls == 1);
+        REQUIRE(find(stats, "set x").calls == 1);
+
+        auto add = find(stats, "add");
+        std::uint64_t histogramCalls = 0;
+        for (auto c : add.histogram) {
+            histogramCalls += c;
+        }
+        REQUIRE(histogramCalls == 10);
+        REQUIRE(add.totalTime.count() > 0);
+    }
+
+    SECTION("should record calls aborted by errors") {
+        std::string res;
+        d.evalString(res,
+            "var res = [];\n"
+            "for (var i = 0; i < 3; i++) {\n"
+            "    try { v.add('x'); } catch (e) { res.push(e.name); }\n"
+            "}\n"
+            "try { BindingStatsTests.Vec(); } catch (e) { res.push('new'); }\n"
+            "res.join(',')"
+        );
+
+        REQUIRE(res == "TypeError,TypeError,TypeError,new");
+
+        auto stats = duk::BindingStats::Snapshot();
+        REQUIRE(find(stats, "add").calls == 13);
+        REQUIRE(find(stats, "constructor").calls == 2);
+        REQUIRE(duk_get_top(d) == 0);
+    }
+
+    SECTION("reset should clear stats") {
+        duk::BindingStats::Reset();
+        REQUIRE(duk::BindingStats::Snapshot().empty());
+    }
+
+    SECTION("should map durations to log buckets") {
+        REQUIRE(duk::BindingStats::BucketOf(std::chrono::nanoseconds(1)) == 0);
+        REQUIRE(duk::BindingStats::BucketOf(std::chrono::nanoseconds(2)) == 1);
+        REQUIRE(duk::BindingStats::BucketOf(std::chrono::nanoseconds(1000)) == 9);
+        REQUIRE(duk::BindingStats::BucketOf(std::chrono::hours(1)) == duk::BindingStats::NumBuckets - 1);
+    }
+}
@@ -0,0 +1,123 @@
+#include <catch/catch.hpp>
+
+#include <duktape-cpp/DuktapeCpp.h>
+
+namespace BorrowedTests {
+
+class Player {
+public:
+    void hit(int damage) { _health -= damage; }
+
+    int health() const { return _health; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.method("hit", &Player::hit);
+        i.property("health", &Player::health);
+    }
+
+private:
+    int _health {100};
+};
+
+class Team {
+public:
+    duk::Borrowed<Player> captain() { return duk::Borrow(_captain); }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.method("captain", &Team::captain);
+    }
+
+private:
+    Player _captain;
+};
+
+}
+
+DUK_CPP_DEF_CLASS_NAME(BorrowedTests::Player);
+DUK_CPP_DEF_CLASS_NAME(BorrowedTests::Team);
+
+TEST_CASE("Borrowed objects", "[duktape]") {
+    using namespace BorrowedTests;
+
+    duk::Context d;
+    Player player;
+
+    SECTION("should call methods of borrowed object") {
+        duk::Context::BorrowScope scope(d);
+        d.addGlobal("player", duk::Borrow(player));
+
+        d.evalStringNoRes("player.hit(30)");
+        REQUIRE(player.health() == 70);
+
+        int health = 0;
+        d.evalString(health, "player.health");
+        REQUIRE(health == 70);
+    }
+
+    SECTION("should share prototype between wrappers") {
+        Player other;
+        duk::Context::BorrowScope scope(d);
+        d.addGlobal("a", duk::Borrow(player));
+        d.addGlobal("b", duk::Borrow(other));
+
+        bool same = false;
+        d.evalString(same, "a.hit === b.hit");
+        REQUIRE(same);
+    }
+
+    SECTION("should get borrowed object from script") {
+        duk::Context::BorrowScope scope(d);
+        d.addGlobal("player", duk::Borrow(player));
+
+        duk::Borrowed<Player> res;
+        d.evalString(res, "player");
+        REQUIRE(res.get() == &player);
+    }
+
+    SECTION("should raise TypeError when used after scope") {
+        {
+            duk::Context::BorrowScope scope(d);
+            d.addGlobal("player", duk::Borrow(player));
+        }
+
+        std::string error;
+        d.evalString(error, "try { player.hit(1); 'ok' } catch (e) { e.name }");
+        REQUIRE(error == "TypeError");
+
+        d.evalString(error, "try { player.health; 'ok' } catch (e) { e.name }");
+        REQUIRE(error == "TypeError");
+        REQUIRE(player.health() == 100);
+    }
+
+    SECTION("should invalidate only objects of the inner scope") {
+        Player other;
+        duk::Context::BorrowScope outer(d);
+        d.addGlobal("a", duk::Borrow(player));
+
+        {
+            duk::Context::BorrowScope inner(d);
+            d.addGlobal("b", duk::Borrow(other));
+        }
+
+        std::string res;
+        d.evalString(res, "a.hit(1); try { b.hit(1); 'ok' } catch (e) { e.name }");
+        REQUIRE(res == "TypeError");
+        REQUIRE(player.health() == 99);
+        REQUIRE(other.health() == 100);
+    }
+
+    SECTION("should not push borrowed object outside of scope") {
+        REQUIRE_THROWS_AS(d.addGlobal("player", duk::Borrow(player)), duk::DuktapeException const &);
+        REQUIRE(duk_get_top(d) == 0);
+    }
+
+    SECTION("should raise TypeError when method returns borrowed object outside of scope") {
+        d.addGlobal("team", std::make_shared<Team>());
+
+        std::string res;
+        d.evalString(res, "try { team.captain(); 'ok' } catch (e) { e.name }");
+        REQUIRE(res == "TypeError");
+    }
+}
@@ -0,0 +1,130 @@
+#include <catch/catch.hpp>
+
+#include <duktape-cpp/DuktapeCpp.h>
+
+namespace CoroutineTests {
+
+class Counter {
+public:
+    void add(int value) { _value += value; }
+    int value() const { return _value; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.method("add", &Counter::add);
+        i.property("value", &Counter::value);
+    }
+
+private:
+    int _value {0};
+};
+
+}
+
+DUK_CPP_DEF_CLASS_NAME(CoroutineTests::Counter);
+
+TEST_CASE("Coroutines", "[duktape]") {
+    using namespace CoroutineTests;
+
+    duk::Context d;
+
+    SECTION("should pass values between script and native code") {
+        duk::Coroutine co;
+        d.evalString(co, "(function (v) { while (true) { v = Duktape.Thread.yield(v * 2); } })");
+
+        int res = 0;
+        co.resume(res, 5);
+        REQUIRE(res == 10);
+
+        co.resume(res, 21);
+        REQUIRE(res == 42);
+        REQUIRE_FALSE(co.isDone());
+
+        SECTION("does not pollute stack") {
+            REQUIRE(duk_get_top(d) == 0);
+        }
+    }
+
+    SECTION("should detect completion") {
+        duk::Coroutine co;
+        d.evalString(co, "(function () { Duktape.Thread.yield(1); return 2; })");
+
+        int res = 0;
+        co.resume(res);
+        REQUIRE(res == 1);
+        REQUIRE_FALSE(co.isDone());
+
+        co.resume(res);
+        REQUIRE(res == 2);
+        REQUIRE(co.isDone());
+
+        REQUIRE_THROWS_AS(co.resumeNoRes(), duk::DuktapeException const &);
+    }
+
+    SECTION("should multiplex many coroutines in a single context") {
+        d.evalStringNoRes(
+            "function actor(id) {\n"
+            "    var n = 0;\n"
+            "    while (true) { n += Duktape.Thread.yield(id * 1000 + n); }\n"
+            "}"
+        );
+
+        std::vector<duk::Coroutine> actors;
+        for (int i = 0; i < 100; ++i) {
+            actors.emplace_back();
+            d.getGlobal("actor", actors.back());
+            actors.back().resumeNoRes(i);
+        }
+
+        for (int i = 0; i < 100; ++i) {
+            int res = 0;
+            actors[i].resume(res, 1);
+            REQUIRE(res == i * 1000 + 1);
+        }
+
+        REQUIRE(duk_get_top(d) == 0);
+    }
+
+    SECTION("should call native methods from coroutine") {
+        auto counter = std::make_shared<Counter>();
+        d.addGlobal("counter", counter);
+
+        duk::Coroutine co;
+        d.evalString(co, "(function (v) { while (true) { counter.add(v); v = Duktape.Thread.yield(counter.value); } })");
+
+        int res = 0;
+        co.resume(res, 3);
+        co.resume(res, 4);
+
+        REQUIRE(res == 7);
+        REQUIRE(counter->value() == 7);
+    }
+
+    SECTION("should restore current thread after native method error caught in coroutine") {
+        auto counter = std::make_shared<Counter>();
+        d.addGlobal("counter", counter);
+
+        d.evalStringNoRes(
+            "var t = new Duktape.Thread(function (v) {\n"
+            "    try { counter.add('x'); } catch (e) {}\n"
+            "    return v + 5;\n"
+            "});"
+        );
+
+        int res = 0;
+        d.evalString(res, "Duktape.Thread.resume(t, 0)");
+
+        REQUIRE(res == 5);
+        REQUIRE(d.current() == d.ptr());
+        REQUIRE(duk_get_top(d) == 0);
+    }
+
+    SECTION("should rethrow script errors") {
+        duk::Coroutine co;
+        d.evalString(co, "(function () { throw new Error('actor failed'); })");
+
+        REQUIRE_THROWS_AS(co.resumeNoRes(), duk::ScriptEvaluationExcepton const &);
+        REQUIRE(co.isDone());
+        REQUIRE(duk_get_top(d) == 0);
+    }
+}
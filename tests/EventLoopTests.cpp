@@ -0,0 +1,128 @@
+#include <catch/catch.hpp>
+
+#include <duktape-cpp/DuktapeCpp.h>
+
+TEST_CASE("Event loop", "[duktape]") {
+    duk::Context d;
+    duk::EventLoop loop(d);
+
+    d.evalStringNoRes("var log = [];");
+
+    auto getLog = [&d] () {
+        std::string log;
+        d.evalString(log, "log.join(',')");
+        return log;
+    };
+
+    SECTION("should run timers in order of their due time") {
+        d.evalStringNoRes(
+            "setTimeout(function () { log.push('b'); }, 20);\n"
+            "setTimeout(function () { log.push('a'); }, 0);\n"
+            "setTimeout(function () { log.push('c'); }, 20);"
+        );
+
+        loop.runUntilIdle();
+
+        REQUIRE(getLog() == "a,b,c");
+        REQUIRE(loop.isIdle());
+        REQUIRE(duk_get_top(d) == 0);
+    }
+
+    SECTION("should run microtasks before timers") {
+        d.evalStringNoRes(
+            "setTimeout(function () { log.push('timer'); }, 0);\n"
+            "queueMicrotask(function () {\n"
+            "    log.push('job1');\n"
+            "    queueMicrotask(function () { log.push('job2'); });\n"
+            "});"
+        );
+
+        loop.runUntilIdle();
+
+        REQUIRE(getLog() == "job1,job2,timer");
+    }
+
+    SECTION("should repeat intervals until cleared") {
+        d.evalStringNoRes(
+            "var n = 0;\n"
+            "var id = setInterval(function () {\n"
+            "    log.push(++n);\n"
+            "    if (n == 3) { clearInterval(id); }\n"
+            "}, 1);"
+        );
+
+        loop.runUntilIdle();
+
+        REQUIRE(getLog() == "1,2,3");
+    }
+
+    SECTION("should cancel timeouts") {
+        d.evalStringNoRes(
+            "var id = setTimeout(function () { log.push('cancelled'); }, 0);\n"
+            "setTimeout(function () { log.push('ok'); }, 0);\n"
+            "clearTimeout(id);"
+        );
+
+        loop.runUntilIdle();
+
+        REQUIRE(getLog() == "ok");
+    }
+
+    SECTION("should clamp invalid and huge delays") {
+        d.evalStringNoRes(
+            "setTimeout(function () { log.push('negative'); }, -5);\n"
+            "setTimeout(function () { log.push('nan'); }, 'soon');\n"
+            "var late = [setTimeout(function () {}, Infinity), setTimeout(function () {}, 1e300)];"
+        );
+
+        bool pending = loop.runOnce(duk::EventLoop::Clock::now() + std::chrono::milliseconds(1));
+
+        REQUIRE(pending);
+        REQUIRE(getLog() == "negative,nan");
+
+        d.evalStringNoRes("late.forEach(clearTimeout);");
+        REQUIRE(loop.isIdle());
+    }
+
+    SECTION("should drop many cancelled timers") {
+        d.evalStringNoRes(
+            "for (var i = 0; i < 10000; i++) { clearTimeout(setTimeout(function () {}, 1e9)); }\n"
+            "setTimeout(function () { log.push('ok'); }, 0);"
+        );
+
+        loop.runUntilIdle();
+
+        REQUIRE(getLog() == "ok");
+        REQUIRE(loop.isIdle());
+    }
+
+    SECTION("runOnce should return when deadline is reached") {
+        d.evalStringNoRes("setTimeout(function () { log.push('late'); }, 10000);");
+
+        bool pending = loop.runOnce(duk::EventLoop::Clock::now() + std::chrono::milliseconds(1));
+
+        REQUIRE(pending);
+        REQUIRE(getLog() == "");
+    }
+
+    SECTION("should rethrow callback errors") {
+        d.evalStringNoRes("setTimeout(function () { throw new Error('timer failed'); }, 0);");
+
+        REQUIRE_THROWS_AS(loop.runUntilIdle(), duk::ScriptEvaluationExcepton const &);
+        REQUIRE(loop.isIdle());
+        REQUIRE(duk_get_top(d) == 0);
+    }
+
+    SECTION("should run many timer callbacks") {
+        d.evalStringNoRes(
+            "var count = 0;\n"
+            "for (var i = 0; i < 10000; i++) { setTimeout(function () { count++; }, 0); }"
+        );
+
+        loop.runUntilIdle();
+
+        int count = 0;
+        d.getGlobal("count", count);
+        REQUIRE(count == 10000);
+    }
+}
@@ -0,0 +1,84 @@
+#include <catch/catch.hpp>
+
+#include <duktape-cpp/DuktapeCpp.h>
+
+namespace GcTests {
+
+class Node {
+public:
+    static std::shared_ptr<Node> create() { return std::make_shared<Node>(); }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.construct(&Node::create);
+    }
+};
+
+}
+
+DUK_CPP_DEF_CLASS_NAME(GcTests::Node);
+
+TEST_CASE("Garbage collection", "[duktape]") {
+    using namespace GcTests;
+
+    duk::Context d;
+    d.registerClass<Node>();
+
+    // cyclic garbage can be freed only by mark-and-sweep
+    d.evalStringNoRes(
+        "function makeGarbage(n) {\n"
+        "    for (var i = 0; i < n; i++) { var x = new GcTests.Node(); x.self = x; x.data = 'node' + i; }\n"
+        "}"
+    );
+
+    SECTION("should collect garbage and report stats") {
+        d.evalStringNoRes("makeGarbage(100)");
+        d.collectGarbage();
+
+        d.evalStringNoRes("makeGarbage(10)");
+        duk::GcStats stats = d.collectGarbage();
+
+        REQUIRE(stats.boxesReleased == 10);
+        REQUIRE(stats.finalizersRun == 10);
+        REQUIRE(stats.objectsFreed >= 10);
+        REQUIRE(stats.duration.count() > 0);
+    }
+
+    SECTION("should run compacting collection") {
+        d.evalStringNoRes("makeGarbage(10)");
+        duk::GcStats stats = d.collectGarbage(duk::GcMode::Compact);
+        REQUIRE(stats.boxesReleased == 10);
+    }
+
+    SECTION("should defer automatic collection") {
+        d.collectGarbage();
+
+        {
+            duk::Context::GcDeferScope scope(d);
+            REQUIRE(d.isGcDeferred());
+
+            d.evalStringNoRes("makeGarbage(20000)");
+
+            duk::GcStats stats = d.collectGarbage();
+            REQUIRE(stats.boxesReleased == 20000);
+            REQUIRE(stats.finalizersRun == 20000);
+            REQUIRE(d.isGcDeferred());
+        }
+
+        REQUIRE_FALSE(d.isGcDeferred());
+    }
+
+    SECTION("should allow nested deferral") {
+        d.deferGc();
+        d.deferGc();
+        d.resumeGc();
+        REQUIRE(d.isGcDeferred());
+        d.resumeGc();
+        REQUIRE_FALSE(d.isGcDeferred());
+    }
+
+    SECTION("should destroy context while collection is deferred") {
+        duk::Context other;
+        other.deferGc();
+    }
+}
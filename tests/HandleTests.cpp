@@ -0,0 +1,166 @@
+#include <catch/catch.hpp>
+
+#include <duktape-cpp/DuktapeCpp.h>
+
+namespace HandleTests {
+
+class Ship {
+public:
+    explicit Ship(int speed): _speed(speed) {}
+
+    static std::shared_ptr<Ship> create(int speed) { return std::make_shared<Ship>(speed); }
+
+    int speed() const { return _speed; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.construct(&Ship::create);
+        i.property("speed", &Ship::speed);
+    }
+
+private:
+    int _speed;
+};
+
+int CountRefs(duk::Context &d) {
+    duk_push_global_stash(d);
+    duk_get_prop_string(d, -1, "refs");
+    duk_enum(d, -1, 0);
+    int count = 0;
+    while (duk_next(d, -1, 0)) {
+        ++count;
+        duk_pop(d);
+    }
+    duk_pop_3(d);
+    return count;
+}
+
+}
+
+DUK_CPP_DEF_CLASS_NAME(HandleTests::Ship);
+
+TEST_CASE("Global and function handles", "[duktape]") {
+    using namespace HandleTests;
+
+    duk::Context d;
+    d.registerClass<Ship>();
+
+    SECTION("global handle should get value resolved once") {
+        d.evalStringNoRes("var limit = 42; var title = 'ship'; var ship = new HandleTests.Ship(7);");
+
+        duk::GlobalHandle<int> limit(d, "limit");
+        duk::GlobalHandle<std::string> title(d, "title");
+        duk::GlobalHandle<std::shared_ptr<Ship>> ship(d, "ship");
+
+        REQUIRE(limit.get() == 42);
+        REQUIRE(title.get() == "ship");
+        REQUIRE(ship.get()->speed() == 7);
+        REQUIRE(duk_get_top(d) == 0);
+
+        SECTION("keeps value until revalidated") {
+            d.evalStringNoRes("limit = 43; ship = new HandleTests.Ship(8);");
+
+            REQUIRE(limit.isStale());
+            REQUIRE(ship.isStale());
+            REQUIRE_FALSE(title.isStale());
+            REQUIRE(limit.get() == 42);
+            REQUIRE(ship.get()->speed() == 7);
+
+            REQUIRE(limit.revalidate());
+            REQUIRE(ship.revalidate());
+            REQUIRE_FALSE(title.revalidate());
+
+            REQUIRE(limit.get() == 43);
+            REQUIRE(ship.get()->speed() == 8);
+            REQUIRE_FALSE(limit.isStale());
+            REQUIRE(duk_get_top(d) == 0);
+        }
+
+        SECTION("throws if variable becomes undefined") {
+            d.evalStringNoRes("delete limit; limit = undefined;");
+            REQUIRE_THROWS_AS(limit.revalidate(), duk::KeyError const &);
+        }
+    }
+
+    SECTION("global handle should throw on undefined variable") {
+        REQUIRE_THROWS_AS(duk::GlobalHandle<int>(d, "missing"), duk::KeyError const &);
+        REQUIRE(CountRefs(d) == 0);
+    }
+
+    SECTION("function handle should call function") {
+        d.evalStringNoRes(
+            "var ticks = 0;"
+            "function onTick(dt) { ticks += dt; return ticks; }"
+            "function describe(ship, name) { return name + ':' + ship.speed; }"
+        );
+
+        duk::FunctionHandle<int(int)> onTick(d, "onTick");
+        for (int i = 0; i < 1000; ++i) {
+            onTick(2);
+        }
+        REQUIRE(onTick(1) == 2001);
+
+        duk::FunctionHandle<std::string(std::shared_ptr<Ship>, std::string)> describe(d, "describe");
+        REQUIRE(describe(std::make_shared<Ship>(3), "s") == "s:3");
+
+        duk::FunctionHandle<void(int)> onTickNoRes(d, "onTick");
+        onTickNoRes(1);
+
+        int ticks = 0;
+        d.getGlobal("ticks", ticks);
+        REQUIRE(ticks == 2002);
+        REQUIRE(duk_get_top(d) == 0);
+
+        SECTION("calls previous function until revalidated") {
+            d.evalStringNoRes("onTick = function (dt) { return -dt; };");
+
+            REQUIRE(onTick.isStale());
+            REQUIRE(onTick(1) == 2003);
+
+            REQUIRE(onTick.revalidate());
+            REQUIRE(onTick(1) == -1);
+            REQUIRE_FALSE(onTick.revalidate());
+        }
+
+        SECTION("throws if variable is not a function anymore") {
+            d.evalStringNoRes("onTick = 1;");
+            REQUIRE_THROWS_AS(onTick.revalidate(), duk::KeyError const &);
+        }
+    }
+
+    SECTION("function handle should throw script errors") {
+        d.evalStringNoRes(
+            "function fail() { throw new Error('boom'); } function failValue() { throw 1; }\n"
+            "function failNull() { throw null; } function failUndefined() { throw undefined; }"
+        );
+
+        duk::FunctionHandle<void()> fail(d, "fail");
+        duk::FunctionHandle<void()> failValue(d, "failValue");
+        duk::FunctionHandle<void()> failNull(d, "failNull");
+        duk::FunctionHandle<void()> failUndefined(d, "failUndefined");
+
+        REQUIRE_THROWS_AS(fail(), duk::ScriptEvaluationExcepton const &);
+        REQUIRE_THROWS_AS(failValue(), duk::ScriptEvaluationExcepton const &);
+        REQUIRE_THROWS_AS(failNull(), duk::ScriptEvaluationExcepton const &);
+        REQUIRE_THROWS_AS(failUndefined(), duk::ScriptEvaluationExcepton const &);
+        REQUIRE(duk_get_top(d) == 0);
+    }
+
+    SECTION("function handle should reject values which are not functions") {
+        d.evalStringNoRes("var notFunction = 1;");
+        REQUIRE_THROWS_AS((duk::FunctionHandle<void()>(d, "notFunction")), duk::KeyError const &);
+        REQUIRE(CountRefs(d) == 0);
+    }
+
+    SECTION("handles should release stashed references") {
+        d.evalStringNoRes("function f() {} var v = {};");
+        {
+            duk::FunctionHandle<void()> f(d, "f");
+            duk::GlobalHandle<int> v(d, "v");
+            duk::GlobalHandle<int> moved(std::move(v));
+
+            REQUIRE(CountRefs(d) == 4);
+        }
+        REQUIRE(CountRefs(d) == 0);
+    }
+}
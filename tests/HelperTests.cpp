@@ -21,4 +21,14 @@ TEST_CASE("helper tests", "[duktape]") {
             REQUIRE(expected == actual);
         }
     }
+
+    SECTION("SplitQualifiedName") {
+        constexpr const char *name = "engine::duk::SomeClass";
+        constexpr auto segments = details::SplitQualifiedName<details::CountNameSegments(name)>(name);
+
+        static_assert(details::CountNameSegments(name) == 3, "three segments");
+        static_assert(segments.items[1].offset == 8 && segments.items[1].length == 3, "duk");
+        REQUIRE(std::string(name + segments.items[2].offset, segments.items[2].length) == "SomeClass");
+        REQUIRE(details::CountNameSegments("SomeClass") == 1);
+    }
 }
@@ -0,0 +1,95 @@
+#include <catch/catch.hpp>
+
+#include <duktape-cpp/DuktapeCpp.h>
+
+namespace HiddenKeysTests {
+
+class Point {
+public:
+    Point() {}
+    Point(int x): _x(x) {}
+
+    static std::shared_ptr<Point> create(int x) { return std::make_shared<Point>(x); }
+
+    int x() const { return _x; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.construct(&Point::create);
+        i.property("x", &Point::x);
+    }
+
+private:
+    int _x {0};
+};
+
+class Tag {
+public:
+    std::string name() const { return "tag"; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.method("name", &Tag::name);
+    }
+};
+
+}
+
+DUK_CPP_DEF_CLASS_NAME(HiddenKeysTests::Point);
+DUK_CPP_DEF_CLASS_NAME(HiddenKeysTests::Tag);
+
+TEST_CASE("Hidden keys", "[duktape]") {
+    using namespace HiddenKeysTests;
+
+    SECTION("should bind the same class in several contexts") {
+        duk::Context d1;
+        duk::Context d2;
+        d1.registerClass<Point>();
+        d2.registerClass<Point>();
+
+        d1.addGlobal("tag", std::make_shared<Tag>());
+        d2.addGlobal("p", std::make_shared<Point>(7));
+
+        int x = 0;
+        d1.evalString(x, "new HiddenKeysTests.Point(3).x");
+        REQUIRE(x == 3);
+
+        d2.evalString(x, "p.x + new HiddenKeysTests.Point(5).x");
+        REQUIRE(x == 12);
+
+        std::string name;
+        d1.evalString(name, "tag.name()");
+        REQUIRE(name == "tag");
+    }
+
+    SECTION("should share prototype between wrappers of a class") {
+        duk::Context d;
+        d.addGlobal("a", std::make_shared<Point>(1));
+        d.addGlobal("b", std::make_shared<Point>(2));
+
+        bool same = false;
+        d.evalString(same, "Object.getPrototypeOf(a) === Object.getPrototypeOf(b)");
+        REQUIRE(same);
+    }
+
+    SECTION("should not expose hidden properties to scripts") {
+        duk::Context d;
+        d.addGlobal("p", std::make_shared<Point>(1));
+
+        int count = -1;
+        d.evalString(count, "Object.getOwnPropertyNames(p).length");
+        REQUIRE(count == 0);
+    }
+
+    SECTION("should find moved context from native calls") {
+        duk::Context src;
+        src.registerClass<Point>();
+
+        duk::Context d(std::move(src));
+
+        int x = 0;
+        d.evalString(x, "new HiddenKeysTests.Point(4).x");
+        REQUIRE(x == 4);
+        REQUIRE(&duk::Context::GetSelfFromContext(d) == &d);
+    }
+}
@@ -0,0 +1,173 @@
+#include <catch/catch.hpp>
+
+#include <cstdint>
+
+#include <duktape-cpp/DuktapeCpp.h>
+
+namespace IntegerTypesTests {
+
+enum class Color { Red = 1, Green = 2, Blue = 3 };
+
+enum class Level: std::uint8_t { Low = 0, High = 255 };
+
+enum class Angle: std::uint8_t {};
+
+class Storage {
+public:
+    void setBig(std::int64_t v) { _big = v; }
+    std::int64_t big() const { return _big; }
+
+    void setSize(std::size_t v) { _size = v; }
+    std::size_t size() const { return _size; }
+
+    void setPort(std::uint16_t v) { _port = v; }
+    std::uint16_t port() const { return _port; }
+
+    void setColor(Color c) { _color = c; }
+    Color color() const { return _color; }
+
+    void setLevel(Level l) { _level = l; }
+    Level level() const { return _level; }
+
+    void setAngle(Angle a) { _angle = a; }
+    Angle angle() const { return _angle; }
+
+    void setSeparator(char c) { _separator = c; }
+    char separator() const { return _separator; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.property("big", &Storage::big, &Storage::setBig);
+        i.property("size", &Storage::size, &Storage::setSize);
+        i.property("port", &Storage::port, &Storage::setPort);
+        i.property("color", &Storage::color, &Storage::setColor);
+        i.property("level", &Storage::level, &Storage::setLevel);
+        i.property("angle", &Storage::angle, &Storage::setAngle);
+        i.property("separator", &Storage::separator, &Storage::setSeparator);
+    }
+
+private:
+    std::int64_t _big {0};
+    std::size_t _size {0};
+    std::uint16_t _port {0};
+    Color _color {Color::Red};
+    Level _level {Level::Low};
+    Angle _angle {};
+    char _separator {','};
+};
+
+}
+
+DUK_CPP_DEF_CLASS_NAME(IntegerTypesTests::Storage);
+DUK_CPP_DEF_RANGE_CHECK(IntegerTypesTests::Level, duk::RangeCheck::Clamp);
+DUK_CPP_DEF_RANGE_CHECK(IntegerTypesTests::Angle, duk::RangeCheck::Wrap);
+
+TEST_CASE("Integer, enum and char types", "[duktape]") {
+    using namespace IntegerTypesTests;
+
+    duk::Context d;
+    auto storage = std::make_shared<Storage>();
+    d.addGlobal("storage", storage);
+
+    SECTION("should convert 64-bit integers") {
+        d.evalStringNoRes("storage.big = -1099511627776");
+        REQUIRE(storage->big() == -1099511627776LL);
+
+        std::int64_t res = 0;
+        d.evalString(res, "storage.big * 2");
+        REQUIRE(res == -2199023255552LL);
+
+        d.addGlobal("max", std::numeric_limits<std::int64_t>::min());
+        bool exact = false;
+        d.evalString(exact, "max === -Math.pow(2, 63)");
+        REQUIRE(exact);
+    }
+
+    SECTION("should convert size_t") {
+        d.evalStringNoRes("storage.size = 4294967296");
+        REQUIRE(storage->size() == 4294967296ULL);
+
+        std::size_t res = 0;
+        d.evalString(res, "storage.size + 1");
+        REQUIRE(res == 4294967297ULL);
+    }
+
+    SECTION("should reject values out of range by default") {
+        d.evalStringNoRes("storage.port = 65535");
+        REQUIRE(storage->port() == 65535);
+
+        std::string res;
+        d.evalString(res,
+            "var errors = [];\n"
+            "[65536, -1, 1.5, NaN].forEach(function (v) {\n"
+            "    try { storage.port = v; } catch (e) { errors.push(e.name); }\n"
+            "});\n"
+            "try { storage.size = -1; } catch (e) { errors.push(e.name); }\n"
+            "errors.join()"
+        );
+        REQUIRE(res == "RangeError,RangeError,RangeError,RangeError,RangeError");
+        REQUIRE(storage->port() == 65535);
+
+        bool isRangeError = false;
+        d.evalString(isRangeError, "try { storage.port = 1e6; false } catch (e) { e instanceof RangeError }");
+        REQUIRE(isRangeError);
+    }
+
+    SECTION("should convert enums as underlying type") {
+        d.evalStringNoRes("storage.color = 3");
+        REQUIRE(storage->color() == Color::Blue);
+
+        int res = 0;
+        d.evalString(res, "storage.color");
+        REQUIRE(res == 3);
+    }
+
+    SECTION("should clamp values with clamp policy") {
+        d.evalStringNoRes("storage.level = 1000");
+        REQUIRE(storage->level() == Level::High);
+
+        d.evalStringNoRes("storage.level = -5");
+        REQUIRE(storage->level() == Level::Low);
+
+        d.evalStringNoRes("storage.level = 7.9");
+        REQUIRE(storage->level() == Level(7));
+    }
+
+    SECTION("should wrap values with wrap policy") {
+        d.evalStringNoRes("storage.angle = 361");
+        REQUIRE(storage->angle() == Angle(105));
+
+        d.evalStringNoRes("storage.angle = -1");
+        REQUIRE(storage->angle() == Angle(255));
+
+        d.evalStringNoRes("storage.angle = NaN");
+        REQUIRE(storage->angle() == Angle(0));
+    }
+
+    SECTION("should convert char to string of length 1") {
+        std::string res;
+        d.evalString(res, "storage.separator");
+        REQUIRE(res == ",");
+
+        d.evalStringNoRes("storage.separator = ';'");
+        REQUIRE(storage->separator() == ';');
+
+        d.evalString(res,
+            "var errors = [];\n"
+            "['ab', '\\u0400', 1].forEach(function (v) {\n"
+            "    try { storage.separator = v; } catch (e) { errors.push(e.name); }\n"
+            "});\n"
+            "errors.join()"
+        );
+        REQUIRE(res == "RangeError,RangeError,TypeError");
+        REQUIRE(storage->separator() == ';');
+    }
+
+    SECTION("should round trip char16_t") {
+        d.addGlobal("ch", u'Ж');
+
+        std::tuple<int, char16_t> res;
+        d.evalString(res, "[ch.charCodeAt(0), ch]");
+        REQUIRE(res == std::make_tuple(0x416, u'Ж'));
+    }
+}
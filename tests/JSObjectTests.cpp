@@ -0,0 +1,141 @@
+#include <string>
+
+#include <catch/catch.hpp>
+
+#include <duktape-cpp/DuktapeCpp.h>
+
+namespace JSObjectTests {
+
+class PluginHost {
+public:
+    static std::shared_ptr<PluginHost> create() { return std::make_shared<PluginHost>(); }
+
+    void attach(duk::JSObject plugin) { _plugin = std::move(plugin); }
+
+    duk::JSObject const & plugin() const { return _plugin; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.construct(&PluginHost::create);
+        i.method("attach", &PluginHost::attach);
+    }
+
+private:
+    duk::JSObject _plugin;
+};
+
+int CountRefs(duk::Context &d) {
+    duk_push_global_stash(d);
+    duk_get_prop_string(d, -1, "refs");
+    duk_enum(d, -1, 0);
+    int count = 0;
+    while (duk_next(d, -1, 0)) {
+        ++count;
+        duk_pop(d);
+    }
+    duk_pop_3(d);
+    return count;
+}
+
+}
+
+DUK_CPP_DEF_CLASS_NAME(JSObjectTests::PluginHost);
+
+TEST_CASE("Javascript object handles", "[duktape]") {
+    using namespace JSObjectTests;
+
+    duk::Context d;
+    d.evalStringNoRes(
+        "function Plugin(name) { this.name = name; this.frames = 0; }"
+        "Plugin.prototype.update = function (dt) { this.frames += dt; return this.frames; };"
+        "Plugin.prototype.describe = function (prefix, suffix) { return prefix + this.name + suffix; };"
+        "Plugin.prototype.fail = function () { throw new Error('plugin failed'); };"
+    );
+
+    duk::PropertyKey update(d, "update");
+    duk::PropertyKey describe(d, "describe");
+    duk::PropertyKey fail(d, "fail");
+    duk::PropertyKey frames(d, "frames");
+    duk::PropertyKey name(d, "name");
+    duk::PropertyKey missing(d, "missing");
+
+    duk::JSObject plugin;
+    d.evalString(plugin, "new Plugin('p')");
+    REQUIRE(plugin.isValid());
+
+    SECTION("should call methods by key") {
+        for (int i = 0; i < 1000; ++i) {
+            plugin.call<void>(update, 1);
+        }
+
+        REQUIRE(plugin.call<int>(update, 2) == 1002);
+        REQUIRE(plugin.call<std::string>(describe, std::string("<"), std::string(">")) == "<p>");
+        REQUIRE(duk_get_top(d) == 0);
+    }
+
+    SECTION("should get and set properties by key") {
+        REQUIRE(plugin.get<std::string>(name) == "p");
+
+        plugin.set(frames, 10);
+        REQUIRE(plugin.get<int>(frames) == 10);
+        REQUIRE(plugin.call<int>(update, 1) == 11);
+
+        REQUIRE(plugin.has(update));
+        REQUIRE_FALSE(plugin.has(missing));
+        REQUIRE_THROWS_AS(plugin.get<int>(missing), duk::KeyError const &);
+        REQUIRE(duk_get_top(d) == 0);
+    }
+
+    SECTION("should throw script errors") {
+        REQUIRE_THROWS_AS(plugin.call<void>(fail), duk::ScriptEvaluationExcepton const &);
+        REQUIRE_THROWS_AS(plugin.call<void>(missing), duk::ScriptEvaluationExcepton const &);
+        REQUIRE(duk_get_top(d) == 0);
+    }
+
+    SECTION("should throw errors of property access") {
+        duk::PropertyKey broken(d, "broken");
+        duk::PropertyKey fixed(d, "fixed");
+        d.evalStringNoRes(
+            "Object.defineProperty(Plugin.prototype, 'broken', { get: function () { throw new Error('getter failed'); } });\n"
+            "Object.defineProperty(Plugin.prototype, 'fixed', { value: 1, writable: false });"
+        );
+
+        REQUIRE_THROWS_AS(plugin.get<int>(broken), duk::ScriptEvaluationExcepton const &);
+        REQUIRE_THROWS_AS(plugin.set(fixed, 2), duk::ScriptEvaluationExcepton const &);
+        REQUIRE_THROWS_AS(plugin.get<int>(name), duk::ScriptEvaluationExcepton const &);
+        REQUIRE(duk_get_top(d) == 0);
+
+        REQUIRE(plugin.get<int>(fixed) == 1);
+        REQUIRE(plugin.call<int>(update, 1) == 1);
+    }
+
+    SECTION("should pass objects between script and native code") {
+        d.registerClass<PluginHost>();
+        d.addGlobal("plugin", plugin);
+        d.evalStringNoRes("var host = new JSObjectTests.PluginHost(); host.attach(new Plugin('attached'));");
+
+        std::shared_ptr<PluginHost> host;
+        d.getGlobal("host", host);
+        REQUIRE(host->plugin().get<std::string>(name) == "attached");
+
+        bool same = false;
+        d.evalString(same, "plugin instanceof Plugin && plugin.name == 'p'");
+        REQUIRE(same);
+
+        duk::JSObject global;
+        d.getGlobal("plugin", global);
+        global.call<void>(update, 5);
+        REQUIRE(plugin.get<int>(frames) == 5);
+    }
+
+    SECTION("should release stashed references") {
+        int refs = CountRefs(d);
+        {
+            duk::JSObject other;
+            d.evalString(other, "new Plugin('other')");
+            duk::PropertyKey key(d, "key");
+            REQUIRE(CountRefs(d) == refs + 2);
+        }
+        REQUIRE(CountRefs(d) == refs);
+    }
+}
@@ -0,0 +1,98 @@
+#include <catch/catch.hpp>
+
+#include <duktape-cpp/DuktapeCpp.h>
+
+namespace LazyRegistrationTests {
+
+class Animal {
+public:
+    virtual ~Animal() {}
+
+    virtual std::string sound() const { return "..."; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.method("sound", &Animal::sound);
+    }
+};
+
+class Dog: public Animal {
+public:
+    static const int Legs = 4;
+
+    static std::shared_ptr<Dog> create() { return std::make_shared<Dog>(); }
+
+    std::string sound() const override { return "woof"; }
+    std::string fetch() const { return "ball"; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.construct(&Dog::create);
+        i.constant("Legs", Legs);
+        i.method("fetch", &Dog::fetch);
+    }
+};
+
+}
+
+DUK_CPP_DEF_CLASS_NAME(LazyRegistrationTests::Animal);
+DUK_CPP_DEF_CLASS_NAME(LazyRegistrationTests::Dog);
+DUK_CPP_DEF_BASE_CLASS(LazyRegistrationTests::Dog, LazyRegistrationTests::Animal);
+DUK_CPP_DEF_POLYMORPHIC(LazyRegistrationTests::Animal);
+
+TEST_CASE("Lazy class registration", "[duktape]") {
+    using namespace LazyRegistrationTests;
+
+    duk::Context d;
+    d.setClassRegistration(duk::ClassRegistration::Lazy);
+    d.registerClass<Animal>();
+    d.registerClass<Dog>();
+
+    SECTION("should define accessor until class is used") {
+        bool res = false;
+        d.evalString(res,
+            "var desc = Object.getOwnPropertyDescriptor(LazyRegistrationTests, 'Dog');\n"
+            "typeof desc.get === 'function' && desc.enumerable"
+        );
+        REQUIRE(res);
+
+        std::string keys;
+        d.evalString(keys, "Object.keys(LazyRegistrationTests).join(',')");
+        REQUIRE(keys == "Animal,Dog");
+    }
+
+    SECTION("should build class on first access") {
+        std::string res;
+        d.evalString(res,
+            "var dog = new LazyRegistrationTests.Dog();\n"
+            "[dog.sound(), dog.fetch(), LazyRegistrationTests.Dog.Legs, dog instanceof LazyRegistrationTests.Dog].join(',')"
+        );
+        REQUIRE(res == "woof,ball,4,true");
+
+        bool replaced = false;
+        d.evalString(replaced,
+            "var desc = Object.getOwnPropertyDescriptor(LazyRegistrationTests, 'Dog');\n"
+            "desc.value === LazyRegistrationTests.Dog && desc.get === undefined"
+        );
+        REQUIRE(replaced);
+    }
+
+    SECTION("should allow to replace class before it is used") {
+        int res = 0;
+        d.evalString(res, "LazyRegistrationTests.Dog = 5; LazyRegistrationTests.Dog");
+        REQUIRE(res == 5);
+    }
+
+    SECTION("should wrap polymorphic pointers with prototype of class not used yet") {
+        std::shared_ptr<Animal> animal = Dog::create();
+        d.addGlobal("animal", animal);
+
+        std::string res;
+        d.evalString(res, "animal.fetch()");
+        REQUIRE(res == "ball");
+
+        bool same = false;
+        d.evalString(same, "Object.getPrototypeOf(animal) === LazyRegistrationTests.Dog.prototype");
+        REQUIRE(same);
+    }
+}
@@ -0,0 +1,137 @@
+#include <catch/catch.hpp>
+
+#include <string>
+#include <utility>
+
+#include <duktape-cpp/DuktapeCpp.h>
+
+namespace LightFuncTests {
+
+class Shape {
+public:
+    virtual ~Shape() {}
+
+    std::string kind() const { return "shape"; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.method("kind", &Shape::kind);
+    }
+};
+
+class Box: public Shape {
+public:
+    static std::shared_ptr<Box> create(int w) {
+        auto b = std::make_shared<Box>();
+        b->_w = w;
+        return b;
+    }
+
+    int width() const { return _w; }
+    void setWidth(int w) { _w = w; }
+    int area(int h) const { return _w * h; }
+    void grow(int a, int b, int c, int d, int e, int f, int g, int h,
+              int i, int j, int k, int l, int m, int n, int o, int p) {
+        _w += a + b + c + d + e + f + g + h + i + j + k + l + m + n + o + p;
+    }
+    void fit(Box &other) { _w = other._w; }
+    int scaled(int k) const { return _w * k; }
+    int scaled(int k, int l) const { return _w * k * l; }
+
+    template <int N>
+    int nth() const { return N; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.construct(&Box::create);
+        i.property("width", &Box::width, &Box::setWidth);
+        i.method("area", &Box::area);
+        i.method("grow", &Box::grow);
+        i.method("fit", &Box::fit);
+        i.method("scaled",
+                 static_cast<int (Box::*)(int) const>(&Box::scaled),
+                 static_cast<int (Box::*)(int, int) const>(&Box::scaled));
+        inspectNth(i, std::make_index_sequence<300>{});
+    }
+
+private:
+    template <class Inspector, std::size_t ... N>
+    static void inspectNth(Inspector &i, std::index_sequence<N...>) {
+        static const std::string names[] = { ("nth" + std::to_string(N))... };
+        (void)std::initializer_list<int> { (i.method(names[N].c_str(), &Box::nth<int(N)>), 0)... };
+    }
+
+    int _w {0};
+};
+
+}
+
+DUK_CPP_DEF_CLASS_NAME(LightFuncTests::Shape);
+DUK_CPP_DEF_CLASS_NAME(LightFuncTests::Box);
+DUK_CPP_DEF_BASE_CLASS(LightFuncTests::Box, LightFuncTests::Shape);
+DUK_CPP_DEF_LIGHTFUNCS(LightFuncTests::Box);
+
+TEST_CASE("Lightfunc bindings", "[duktape]") {
+    using namespace LightFuncTests;
+
+    duk::Context d;
+    d.registerClass<Box>();
+
+    SECTION("should bind methods as lightfuncs") {
+        d.evalStringNoRes("var proto = LightFuncTests.Box.prototype;");
+
+        duk_get_global_string(d, "proto");
+        duk_get_prop_string(d, -1, "area");
+        REQUIRE(duk_is_lightfunc(d, -1));
+        duk_pop(d);
+
+        // overloads keep function objects
+        duk_get_prop_string(d, -1, "scaled");
+        REQUIRE_FALSE(duk_is_lightfunc(d, -1));
+        duk_pop_2(d);
+    }
+
+    SECTION("should call methods and accessors") {
+        int res = 0;
+        d.evalString(res,
+            "var b = new LightFuncTests.Box(2);\n"
+            "b.width = b.width + 1;\n"
+            "b.area(4) + b.scaled(2) + b.scaled(2, 3)"
+        );
+        REQUIRE(res == 12 + 6 + 18);
+    }
+
+    SECTION("should call methods with more arguments than lightfunc supports") {
+        int res = 0;
+        d.evalString(res,
+            "var b = new LightFuncTests.Box(0);\n"
+            "b.grow(1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 100);\n"
+            "b.width"
+        );
+        REQUIRE(res == 16);
+    }
+
+    SECTION("should select binding of every member of large class") {
+        std::string res;
+        d.evalString(res,
+            "var b = new LightFuncTests.Box(0);\n"
+            "var bad = [];\n"
+            "for (var i = 0; i < 300; ++i) { if (b['nth' + i]() !== i) bad.push(i); }\n"
+            "bad.join(',')"
+        );
+        REQUIRE(res == "");
+    }
+
+    SECTION("should inherit members of base class and check receiver") {
+        std::string res;
+        d.evalString(res, "new LightFuncTests.Box(1).kind()");
+        REQUIRE(res == "shape");
+
+        int w = 0;
+        d.evalString(w, "var a = new LightFuncTests.Box(1); a.fit(new LightFuncTests.Box(5)); a.width");
+        REQUIRE(w == 5);
+
+        d.evalString(res, "try { LightFuncTests.Box.prototype.area.call({}, 1); 'ok' } catch (e) { e.name }");
+        REQUIRE(res == "TypeError");
+    }
+}
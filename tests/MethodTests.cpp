@@ -74,8 +74,7 @@ static void registerMethod(duk::Context &d, const char *objName, const char *met
 
     auto testIdx = duk_push_object(d);
 
-    duk_push_pointer(d, obj);
-    duk_put_prop_string(d, testIdx, "\xff" "obj_ptr");
+    duk::details::PutNativeObject(d, testIdx, obj);
 
     duk::details::PushMethod(d, method);
     duk_put_prop_string(d, testIdx, methodName);
@@ -89,8 +88,7 @@ static void registerMethod(duk::Context &d, const char *objName, const char *met
 
     auto testIdx = duk_push_object(d);
 
-    duk_push_pointer(d, obj);
-    duk_put_prop_string(d, testIdx, "\xff" "obj_ptr");
+    duk::details::PutNativeObject(d, testIdx, obj);
 
     duk::details::PushMethod(d, method);
     duk_put_prop_string(d, testIdx, methodName);
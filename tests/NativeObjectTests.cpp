@@ -0,0 +1,111 @@
+#include <catch/catch.hpp>
+
+#include <duktape-cpp/DuktapeCpp.h>
+
+namespace NativeObjectTests {
+
+class Named {
+public:
+    std::string name() const { return _name; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.method("name", &Named::name);
+    }
+
+    std::string _name {"named"};
+};
+
+class Counter {
+public:
+    virtual ~Counter() {}
+
+    int count() const { return _count; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.method("count", &Counter::count);
+    }
+
+    int _count {0};
+};
+
+/**
+ * Counter is not the first base, so pointer to it differs from pointer to the object
+ */
+class Item: public Named, public Counter {
+public:
+    static std::shared_ptr<Item> create() { return std::make_shared<Item>(); }
+
+    void add(Counter &other) { _count += other.count() + 1; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.construct(&Item::create);
+        i.method("add", &Item::add);
+    }
+};
+
+class Other {
+public:
+    static std::shared_ptr<Other> create() { return std::make_shared<Other>(); }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.construct(&Other::create);
+    }
+};
+
+}
+
+DUK_CPP_DEF_CLASS_NAME(NativeObjectTests::Counter);
+DUK_CPP_DEF_CLASS_NAME(NativeObjectTests::Item);
+DUK_CPP_DEF_BASE_CLASS(NativeObjectTests::Item, NativeObjectTests::Counter);
+DUK_CPP_DEF_CLASS_NAME(NativeObjectTests::Other);
+
+TEST_CASE("Native object references", "[duktape]") {
+    using namespace NativeObjectTests;
+
+    duk::Context d;
+    d.registerClass<Item>();
+    d.registerClass<Other>();
+
+    SECTION("should convert pointer to base class with non-zero offset") {
+        int res = -1;
+        d.evalString(res,
+            "var a = new NativeObjectTests.Item();\n"
+            "var b = new NativeObjectTests.Item();\n"
+            "b.add(a); b.add(a);\n"
+            "a.add(b);\n"
+            "a.count()"
+        );
+        REQUIRE(res == 3);
+    }
+
+    SECTION("should reject object of unrelated class") {
+        std::string res;
+        d.evalString(res,
+            "try { new NativeObjectTests.Item().add(new NativeObjectTests.Other()); 'ok' }\n"
+            "catch (e) { e.name + ': ' + e.message }"
+        );
+        REQUIRE(res == "TypeError: Expected native object of class NativeObjectTests::Counter, got NativeObjectTests::Other");
+    }
+
+    SECTION("should reject plain javascript object") {
+        std::string res;
+        d.evalString(res, "try { new NativeObjectTests.Item().add({}); 'ok' } catch (e) { e.name }");
+        REQUIRE(res == "TypeError");
+
+        d.evalString(res, "try { new NativeObjectTests.Item().count.call({}); 'ok' } catch (e) { e.name }");
+        REQUIRE(res == "TypeError");
+    }
+
+    SECTION("should get native object of base class from wrapper") {
+        auto item = std::make_shared<Item>();
+        d.addGlobal("item", item);
+
+        Counter counter;
+        d.evalString(counter, "item.add(item); item");
+        REQUIRE(counter.count() == 1);
+    }
+}
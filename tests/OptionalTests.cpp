@@ -0,0 +1,130 @@
+#include <catch/catch.hpp>
+
+#include <duktape-cpp/DuktapeCpp.h>
+
+#if DUK_CPP_HAS_OPTIONAL
+
+namespace OptionalTests {
+
+class Window {
+public:
+    void resize(int width, std::optional<int> height) {
+        _width = width;
+        _height = height.value_or(width);
+    }
+
+    std::string title(std::optional<std::string> prefix) const {
+        return prefix ? *prefix + ": main" : "main";
+    }
+
+    void move(int x) { _x = x; }
+    void move(int x, std::optional<int> y) { _x = x; _y = y.value_or(-1); }
+    void moveTo(std::string anchor) { _anchor = anchor; }
+
+    std::optional<int> parent() const { return _parent; }
+
+    std::variant<int, std::string, bool> tag() const { return _tag; }
+    void setTag(std::variant<int, std::string, bool> tag) { _tag = tag; }
+
+    int height() const { return _height; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.method("resize", &Window::resize);
+        i.method("title", &Window::title);
+        i.method("move",
+            static_cast<void (Window::*)(int, std::optional<int>)>(&Window::move),
+            &Window::moveTo);
+        i.method("parent", &Window::parent);
+        i.property("tag", &Window::tag, &Window::setTag);
+    }
+
+    int _width {0};
+    int _height {0};
+    int _x {0};
+    int _y {0};
+    std::string _anchor;
+    std::optional<int> _parent;
+    std::variant<int, std::string, bool> _tag;
+};
+
+}
+
+DUK_CPP_DEF_CLASS_NAME(OptionalTests::Window);
+
+TEST_CASE("Optional and variant types", "[duktape]") {
+    using namespace OptionalTests;
+
+    duk::Context d;
+    auto window = std::make_shared<Window>();
+    d.addGlobal("window", window);
+
+    SECTION("should read missing, undefined and null arguments as empty") {
+        d.evalStringNoRes("window.resize(10)");
+        REQUIRE(window->height() == 10);
+
+        d.evalStringNoRes("window.resize(10, 20)");
+        REQUIRE(window->height() == 20);
+
+        d.evalStringNoRes("window.resize(30, null)");
+        REQUIRE(window->height() == 30);
+
+        std::string res;
+        d.evalString(res, "window.title(undefined) + '|' + window.title('app')");
+        REQUIRE(res == "main|app: main");
+    }
+
+    SECTION("should push empty optional as null") {
+        bool isNull = false;
+        d.evalString(isNull, "window.parent() === null");
+        REQUIRE(isNull);
+
+        window->_parent = 5;
+        int parent = 0;
+        d.evalString(parent, "window.parent()");
+        REQUIRE(parent == 5);
+    }
+
+    SECTION("should allow omitting trailing optional arguments of overloads") {
+        d.evalStringNoRes("window.move(4)");
+        REQUIRE(window->_x == 4);
+        REQUIRE(window->_y == -1);
+
+        d.evalStringNoRes("window.move(5, 6)");
+        REQUIRE(window->_y == 6);
+
+        d.evalStringNoRes("window.move('center')");
+        REQUIRE(window->_anchor == "center");
+    }
+
+    SECTION("should dispatch variant by javascript type") {
+        d.evalStringNoRes("window.tag = 'main'");
+        REQUIRE(std::get<std::string>(window->_tag) == "main");
+
+        d.evalStringNoRes("window.tag = 7");
+        REQUIRE(std::get<int>(window->_tag) == 7);
+
+        d.evalStringNoRes("window.tag = true");
+        REQUIRE(std::get<bool>(window->_tag) == true);
+
+        std::string type;
+        d.evalString(type, "typeof window.tag");
+        REQUIRE(type == "boolean");
+
+        d.evalString(type, "try { window.tag = {}; 'ok' } catch (e) { e.name }");
+        REQUIRE(type == "TypeError");
+    }
+
+    SECTION("should convert monostate to undefined") {
+        std::variant<std::monostate, int> value;
+        d.evalString(value, "undefined");
+        REQUIRE(value.index() == 0);
+
+        d.addGlobal("empty", std::variant<std::monostate, int>());
+        bool isUndefined = false;
+        d.evalString(isUndefined, "empty === undefined");
+        REQUIRE(isUndefined);
+    }
+}
+
+#endif
@@ -0,0 +1,77 @@
+#include <catch/catch.hpp>
+
+#include <duktape-cpp/DuktapeCpp.h>
+
+namespace OverloadTests {
+
+class Label {
+public:
+    Label() = default;
+    Label(std::string text) : _text(std::move(text)) {}
+    Label(std::string text, int size) : _text(std::move(text)), _size(size) {}
+
+    static std::shared_ptr<Label> create() { return std::make_shared<Label>(); }
+    static std::shared_ptr<Label> createText(std::string text) { return std::make_shared<Label>(text); }
+    static std::shared_ptr<Label> createTextSize(std::string text, int size) { return std::make_shared<Label>(text, size); }
+
+    std::string describe() const { return _text + "/" + std::to_string(_size); }
+
+    void set(int size) { _size = size; }
+    void setText(std::string text) { _text = std::move(text); }
+    void setBoth(std::string text, int size) { _text = std::move(text); _size = size; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.construct(&Label::create, &Label::createText, &Label::createTextSize);
+        i.method("set", &Label::set, &Label::setText, &Label::setBoth);
+        i.method("describe", &Label::describe);
+    }
+
+private:
+    std::string _text;
+    int _size {0};
+};
+
+}
+
+DUK_CPP_DEF_CLASS_NAME(OverloadTests::Label);
+
+TEST_CASE("Overloads", "[duktape]") {
+    using namespace OverloadTests;
+
+    duk::Context d;
+    d.registerClass<Label>();
+
+    SECTION("should select constructor by number of arguments") {
+        std::string res;
+        d.evalString(res, "new OverloadTests.Label().describe()");
+        REQUIRE(res == "/0");
+
+        d.evalString(res, "new OverloadTests.Label('a').describe()");
+        REQUIRE(res == "a/0");
+
+        d.evalString(res, "new OverloadTests.Label('b', 12).describe()");
+        REQUIRE(res == "b/12");
+    }
+
+    SECTION("should select method by argument types") {
+        std::string res;
+        d.evalString(res, "var l = new OverloadTests.Label('x'); l.set(5); l.describe()");
+        REQUIRE(res == "x/5");
+
+        d.evalString(res, "l.set('y'); l.describe()");
+        REQUIRE(res == "y/5");
+
+        d.evalString(res, "l.set('z', 7); l.describe()");
+        REQUIRE(res == "z/7");
+    }
+
+    SECTION("should raise TypeError if no overload matches") {
+        std::string res;
+        d.evalString(res, "try { new OverloadTests.Label().set(true); 'ok' } catch (e) { e.name }");
+        REQUIRE(res == "TypeError");
+
+        d.evalString(res, "try { new OverloadTests.Label(1, 2, 3); 'ok' } catch (e) { e.name }");
+        REQUIRE(res == "TypeError");
+    }
+}
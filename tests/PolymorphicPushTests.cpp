@@ -0,0 +1,188 @@
+#include <catch/catch.hpp>
+
+#include <duktape-cpp/DuktapeCpp.h>
+
+namespace PolymorphicPushTests {
+
+class Shape {
+public:
+    virtual ~Shape() {}
+
+    virtual int area() const = 0;
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.method("area", &Shape::area);
+    }
+};
+
+class Rect: public Shape {
+public:
+    Rect(int w, int h) : _w(w), _h(h) {}
+
+    int area() const override { return _w * _h; }
+
+    int width() const { return _w; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.construct(&std::make_shared<Rect, int, int>);
+        i.property("width", &Rect::width);
+    }
+
+private:
+    int _w;
+    int _h;
+};
+
+class Square: public Rect {
+public:
+    explicit Square(int side) : Rect(side, side) {}
+
+    bool isSquare() const { return true; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.construct(&std::make_shared<Square, int>);
+        i.method("isSquare", &Square::isSquare);
+    }
+};
+
+/**
+ * Not registered in context
+ */
+class Circle: public Shape {
+public:
+    int area() const override { return 3; }
+};
+
+/**
+ * Not registered in context, derived from registered class
+ */
+class ColoredSquare: public Square {
+public:
+    ColoredSquare() : Square(2) {}
+};
+
+}
+
+DUK_CPP_DEF_CLASS_NAME(PolymorphicPushTests::Shape);
+DUK_CPP_DEF_POLYMORPHIC(PolymorphicPushTests::Shape);
+
+DUK_CPP_DEF_CLASS_NAME(PolymorphicPushTests::Rect);
+DUK_CPP_DEF_BASE_CLASS(PolymorphicPushTests::Rect, PolymorphicPushTests::Shape);
+DUK_CPP_DEF_POLYMORPHIC(PolymorphicPushTests::Rect);
+
+DUK_CPP_DEF_CLASS_NAME(PolymorphicPushTests::Square);
+DUK_CPP_DEF_BASE_CLASS(PolymorphicPushTests::Square, PolymorphicPushTests::Rect);
+
+TEST_CASE("Push of polymorphic classes", "[duktape-cpp]") {
+    using namespace PolymorphicPushTests;
+
+    duk::Context ctx;
+    ctx.registerClass<Rect>();
+    ctx.registerClass<Square>();
+
+    SECTION("should wrap pointer to base with prototype of the most-derived registered class") {
+        std::shared_ptr<Shape> shape = std::make_shared<Square>(3);
+        ctx.addGlobal("shape", shape);
+
+        std::tuple<int, int, bool> res;
+        ctx.evalString(res, "[shape.area(), shape.width, shape.isSquare()]");
+
+        REQUIRE(res == std::make_tuple(9, 3, true));
+    }
+
+    SECTION("should share prototype with objects created from script") {
+        std::shared_ptr<Rect> rect = std::make_shared<Square>(2);
+        ctx.addGlobal("rect", rect);
+
+        bool same = false;
+        ctx.evalString(same, "Object.getPrototypeOf(rect) === Object.getPrototypeOf(new PolymorphicPushTests.Square(1))");
+
+        REQUIRE(same);
+    }
+
+    SECTION("should fall back to prototype of static type if dynamic type is not registered") {
+        std::shared_ptr<Shape> shape = std::make_shared<Circle>();
+        ctx.addGlobal("shape", shape);
+
+        std::tuple<int, bool> res;
+        ctx.evalString(res, "[shape.area(), shape.width === undefined]");
+
+        REQUIRE(res == std::make_tuple(3, true));
+    }
+
+    SECTION("should use the most-derived registered ancestor of unregistered dynamic type") {
+        std::shared_ptr<Shape> shape = std::make_shared<ColoredSquare>();
+        ctx.addGlobal("shape", shape);
+
+        std::tuple<int, bool, bool> res;
+        ctx.evalString(res, "[shape.width, shape.isSquare(), shape instanceof PolymorphicPushTests.Square]");
+        REQUIRE(res == std::make_tuple(2, true, true));
+
+        std::shared_ptr<Square> square;
+        ctx.getGlobal("shape", square);
+        REQUIRE(square.get() == shape.get());
+    }
+
+    SECTION("should find registered ancestor among lazily registered classes") {
+        duk::Context lazy;
+        lazy.setClassRegistration(duk::ClassRegistration::Lazy);
+        lazy.registerClass<Rect>();
+        lazy.registerClass<Square>();
+
+        std::shared_ptr<Shape> shape = std::make_shared<ColoredSquare>();
+        lazy.addGlobal("shape", shape);
+
+        bool isSquare = false;
+        lazy.evalString(isSquare, "shape.isSquare()");
+        REQUIRE(isSquare);
+    }
+
+    SECTION("should wrap unique pointer to base") {
+        std::unique_ptr<Shape> shape = std::make_unique<Square>(4);
+        ctx.addGlobal("shape", std::move(shape));
+
+        bool isSquare = false;
+        ctx.evalString(isSquare, "shape.isSquare()");
+
+        REQUIRE(isSquare);
+    }
+
+    SECTION("should wrap borrowed reference to base") {
+        Square square(5);
+        duk::Context::BorrowScope scope(ctx);
+        ctx.addGlobal("shape", duk::Borrow<Shape>(square));
+
+        int width = 0;
+        ctx.evalString(width, "shape.width");
+
+        REQUIRE(width == 5);
+    }
+
+    SECTION("should get pointers to any level of hierarchy") {
+        ctx.evalStringNoRes("var square = new PolymorphicPushTests.Square(6)");
+
+        std::shared_ptr<Shape> shape;
+        ctx.getGlobal("square", shape);
+        std::shared_ptr<Rect> rect;
+        ctx.getGlobal("square", rect);
+        std::shared_ptr<Square> square;
+        ctx.getGlobal("square", square);
+
+        REQUIRE(shape != nullptr);
+        REQUIRE(shape->area() == 36);
+        REQUIRE(rect.get() == square.get());
+    }
+
+    SECTION("should pass pointer to base back to native code") {
+        std::shared_ptr<Shape> shape = std::make_shared<Square>(7);
+        ctx.addGlobal("shape", shape);
+
+        std::shared_ptr<Square> square;
+        ctx.getGlobal("shape", square);
+
+        REQUIRE(square.get() == shape.get());
+    }
+}
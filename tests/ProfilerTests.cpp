@@ -0,0 +1,65 @@
+#include <catch/catch.hpp>
+
+#include <duktape-cpp/DuktapeCpp.h>
+
+TEST_CASE("Profiler", "[duktape]") {
+    duk::Context d("profiled.js");
+    duk::Profiler profiler(d, std::chrono::microseconds(100));
+
+    if (!duk::Context::HasInterruptHook()) {
+        SECTION("should require interrupt hook") {
+            REQUIRE_THROWS_AS(profiler.start(), duk::DuktapeException const &);
+        }
+        return;
+    }
+
+    d.evalStringNoRes(
+        "function inner(n) { var s = 0; for (var i = 0; i < n; i++) { s += i % 7; } return s; }\n"
+        "function outer() { var s = 0; for (var i = 0; i < 200; i++) { s += inner(20000); } return s; }"
+    );
+
+    SECTION("should collect samples of running script") {
+        profiler.start();
+        d.evalStringNoRes("outer()");
+        profiler.stop();
+
+        std::string stacks = profiler.collapsedStacks();
+
+        REQUIRE(profiler.numSamples() > 0);
+        REQUIRE(stacks.find("outer (profiled.js:") != std::string::npos);
+        REQUIRE(stacks.find(";inner (profiled.js:") != std::string::npos);
+        REQUIRE(duk_get_top(d) == 0);
+
+        SECTION("reset should remove samples") {
+            profiler.reset();
+            REQUIRE(profiler.numSamples() == 0);
+            REQUIRE(profiler.collapsedStacks().empty());
+        }
+    }
+
+    SECTION("should sample stack of the resumed thread") {
+        d.evalStringNoRes(
+            "function run() {\n"
+            "    var t = new Duktape.Thread(function coroutine() { var s = outer(); return s; });\n"
+            "    return Duktape.Thread.resume(t);\n"
+            "}"
+        );
+
+        profiler.start();
+        d.evalStringNoRes("run()");
+        profiler.stop();
+
+        std::string stacks = profiler.collapsedStacks();
+
+        REQUIRE(profiler.numSamples() > 0);
+        REQUIRE(stacks.find("run (profiled.js:") != std::string::npos);
+        REQUIRE(stacks.find(";coroutine (profiled.js:") != std::string::npos);
+        REQUIRE(stacks.find(";outer (profiled.js:") != std::string::npos);
+        REQUIRE(duk_get_top(d) == 0);
+    }
+
+    SECTION("should not collect samples when stopped") {
+        d.evalStringNoRes("outer()");
+        REQUIRE(profiler.numSamples() == 0);
+    }
+}
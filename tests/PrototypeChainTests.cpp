@@ -0,0 +1,112 @@
+#include <catch/catch.hpp>
+
+#include <duktape-cpp/DuktapeCpp.h>
+
+namespace PrototypeChainTests {
+
+class Animal {
+public:
+    virtual ~Animal() {}
+
+    virtual std::string sound() const { return "..."; }
+
+    int legs() const { return 4; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.construct(&std::make_shared<Animal>);
+        i.method("sound", &Animal::sound);
+        i.method("legs", &Animal::legs);
+    }
+};
+
+class Dog: public Animal {
+public:
+    std::string sound() const override { return "woof"; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.construct(&std::make_shared<Dog>);
+        i.method("sound", &Dog::sound);
+    }
+};
+
+class Puppy: public Dog {
+public:
+    bool small() const { return true; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.construct(&std::make_shared<Puppy>);
+        i.method("small", &Puppy::small);
+    }
+};
+
+}
+
+DUK_CPP_DEF_CLASS_NAME(PrototypeChainTests::Animal);
+
+DUK_CPP_DEF_CLASS_NAME(PrototypeChainTests::Dog);
+DUK_CPP_DEF_BASE_CLASS(PrototypeChainTests::Dog, PrototypeChainTests::Animal);
+
+DUK_CPP_DEF_CLASS_NAME(PrototypeChainTests::Puppy);
+DUK_CPP_DEF_BASE_CLASS(PrototypeChainTests::Puppy, PrototypeChainTests::Dog);
+
+TEST_CASE("Prototype chains", "[duktape-cpp]") {
+    using namespace PrototypeChainTests;
+
+    duk::Context ctx;
+    ctx.registerClass<Animal>();
+    ctx.registerClass<Dog>();
+    ctx.registerClass<Puppy>();
+
+    ctx.evalStringNoRes("var ns = PrototypeChainTests; var puppy = new ns.Puppy()");
+
+    SECTION("should support instanceof for every level of hierarchy") {
+        std::tuple<bool, bool, bool> res;
+        ctx.evalString(res, "[puppy instanceof ns.Puppy, puppy instanceof ns.Dog, puppy instanceof ns.Animal]");
+        REQUIRE(res == std::make_tuple(true, true, true));
+
+        bool isPuppy = true;
+        ctx.evalString(isPuppy, "new ns.Dog() instanceof ns.Puppy");
+        REQUIRE(!isPuppy);
+    }
+
+    SECTION("should chain derived prototype to base prototype") {
+        std::tuple<bool, bool> res;
+        ctx.evalString(res,
+            "[Object.getPrototypeOf(ns.Puppy.prototype) === ns.Dog.prototype,"
+            " Object.getPrototypeOf(ns.Dog.prototype) === ns.Animal.prototype]"
+        );
+        REQUIRE(res == std::make_tuple(true, true));
+    }
+
+    SECTION("should inherit methods instead of copying them into instances") {
+        std::tuple<bool, int, bool> res;
+        ctx.evalString(res,
+            "[puppy.hasOwnProperty('legs'), Object.keys(puppy).length,"
+            " puppy.legs === new ns.Animal().legs]"
+        );
+        REQUIRE(res == std::make_tuple(false, 0, true));
+    }
+
+    SECTION("should call overridden and inherited methods") {
+        std::tuple<std::string, int, bool> res;
+        ctx.evalString(res, "[puppy.sound(), puppy.legs(), puppy.small()]");
+        REQUIRE(res == std::make_tuple(std::string("woof"), 4, true));
+    }
+
+    SECTION("should set constructor of prototype") {
+        bool res = false;
+        ctx.evalString(res, "puppy.constructor === ns.Puppy");
+        REQUIRE(res);
+    }
+
+    SECTION("should support instanceof for pushed objects") {
+        ctx.addGlobal("dog", std::make_shared<Dog>());
+
+        std::tuple<bool, bool> res;
+        ctx.evalString(res, "[dog instanceof ns.Dog, dog instanceof ns.Animal]");
+        REQUIRE(res == std::make_tuple(true, true));
+    }
+}
@@ -63,8 +63,7 @@ TEST_CASE("PushObjectInspector tests", "[duktape]") {
 
         duk_push_global_object(d);
         auto pIdx = duk_push_object(d);
-        duk_push_pointer(d, &p);
-        duk_put_prop_string(d, pIdx, "\xff" "obj_ptr");
+        duk::details::PutNativeObject(d, pIdx, &p);
         duk::details::PushObjectInspector inspector(d, pIdx);
         Inspect<Player>::inspect(inspector);
         duk_put_prop_string(d, -2, "Player");
@@ -120,8 +119,7 @@ TEST_CASE("PushObjectInspector tests", "[duktape]") {
 
         duk_push_global_object(d);
         auto pIdx = duk_push_object(d);
-        duk_push_pointer(d, &p);
-        duk_put_prop_string(d, pIdx, "\xff" "obj_ptr");
+        duk::details::PutNativeObject(d, pIdx, &p);
         duk::details::PushObjectInspector inspector(d, pIdx);
         Inspect<Player>::inspect(inspector);
         duk_put_prop_string(d, -2, "Player");
@@ -0,0 +1,131 @@
+#include <catch/catch.hpp>
+
+#include <duktape-cpp/DuktapeCpp.h>
+
+namespace ReferenceResultTests {
+
+class Transform {
+public:
+    int x() const { return _x; }
+    void setX(int x) { _x = x; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.property("x", &Transform::x, &Transform::setX);
+    }
+
+private:
+    int _x {0};
+};
+
+class Entity {
+public:
+    static int alive;
+
+    Entity() { alive += 1; }
+    Entity(Entity const &that) : _transform(that._transform) { alive += 1; }
+    ~Entity() { alive -= 1; }
+
+    Transform & transform() { return _transform; }
+    Transform const * parent() const { return nullptr; }
+    Transform const * self() const { return &_transform; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.method("transform", &Entity::transform);
+        i.method("parent", &Entity::parent);
+        i.method("self", &Entity::self);
+    }
+
+private:
+    Transform _transform;
+};
+
+int Entity::alive = 0;
+
+class World {
+public:
+    Entity makeEntity() const { return Entity(); }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.method("makeEntity", &World::makeEntity);
+    }
+};
+
+}
+
+DUK_CPP_DEF_CLASS_NAME(ReferenceResultTests::Transform);
+DUK_CPP_DEF_CLASS_NAME(ReferenceResultTests::Entity);
+DUK_CPP_DEF_CLASS_NAME(ReferenceResultTests::World);
+
+TEST_CASE("Methods returning references", "[duktape]") {
+    using namespace ReferenceResultTests;
+
+    duk::Context d;
+    Entity entity;
+
+    SECTION("should reference original object") {
+        duk::Context::BorrowScope scope(d);
+        d.addGlobal("entity", duk::Borrow(entity));
+
+        d.evalStringNoRes("entity.transform().x = 5");
+        REQUIRE(entity.transform().x() == 5);
+
+        int x = 0;
+        d.evalString(x, "entity.self().x");
+        REQUIRE(x == 5);
+    }
+
+    SECTION("should push null pointers as null") {
+        duk::Context::BorrowScope scope(d);
+        d.addGlobal("entity", duk::Borrow(entity));
+
+        bool isNull = false;
+        d.evalString(isNull, "entity.parent() === null");
+        REQUIRE(isNull);
+    }
+
+    SECTION("should keep parent alive") {
+        int aliveBefore = Entity::alive;
+        d.addGlobal("world", std::make_shared<World>());
+
+        d.evalStringNoRes("var t = world.makeEntity().transform(); t.x = 7;");
+        d.collectGarbage();
+        REQUIRE(Entity::alive == aliveBefore + 1);
+
+        int x = 0;
+        d.evalString(x, "t.x");
+        REQUIRE(x == 7);
+
+        d.evalStringNoRes("t = null");
+        d.collectGarbage();
+        REQUIRE(Entity::alive == aliveBefore);
+    }
+
+    SECTION("should invalidate references to borrowed objects with scope") {
+        {
+            duk::Context::BorrowScope scope(d);
+            d.addGlobal("entity", duk::Borrow(entity));
+            d.evalStringNoRes("var t = entity.transform()");
+        }
+
+        std::string res;
+        d.evalString(res, "try { t.x = 1; 'ok' } catch (e) { e.name }");
+        REQUIRE(res == "TypeError");
+        REQUIRE(entity.transform().x() == 0);
+    }
+
+    SECTION("should track references in the scope of their parent") {
+        duk::Context::BorrowScope outer(d);
+        d.addGlobal("entity", duk::Borrow(entity));
+
+        {
+            duk::Context::BorrowScope inner(d);
+            d.evalStringNoRes("var t = entity.transform()");
+        }
+
+        d.evalStringNoRes("t.x = 3");
+        REQUIRE(entity.transform().x() == 3);
+    }
+}
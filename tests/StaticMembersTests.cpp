@@ -0,0 +1,89 @@
+#include <catch/catch.hpp>
+
+#include <duktape-cpp/DuktapeCpp.h>
+
+namespace StaticMembersTests {
+
+class Key {
+public:
+    static const int Escape = 27;
+
+    static std::shared_ptr<Key> create() { return std::make_shared<Key>(); }
+
+    static std::string nameOf(int code) { return code == Escape ? "Escape" : "Unknown"; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.construct(&Key::create);
+        i.constant("Escape", Escape);
+        i.constant("Prefix", std::string("key_"));
+        i.staticMethod("nameOf", &Key::nameOf);
+    }
+};
+
+class Math {
+public:
+    static int add(int a, int b) { return a + b; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.constant("Answer", 42);
+        i.staticMethod("add", &Math::add);
+    }
+};
+
+}
+
+DUK_CPP_DEF_CLASS_NAME(StaticMembersTests::Key);
+DUK_CPP_DEF_CLASS_NAME(StaticMembersTests::Math);
+
+TEST_CASE("Static members", "[duktape]") {
+    using namespace StaticMembersTests;
+
+    duk::Context d;
+    d.registerClass<Key>();
+    d.registerClass<Math>();
+
+    SECTION("should define constants on constructor") {
+        int code = 0;
+        d.evalString(code, "StaticMembersTests.Key.Escape");
+        REQUIRE(code == 27);
+
+        std::string prefix;
+        d.evalString(prefix, "StaticMembersTests.Key.Prefix");
+        REQUIRE(prefix == "key_");
+    }
+
+    SECTION("constants should be read-only") {
+        int code = 0;
+        d.evalString(code, "StaticMembersTests.Key.Escape = 1; StaticMembersTests.Key.Escape");
+        REQUIRE(code == 27);
+
+        std::string error;
+        d.evalString(error, "(function () { 'use strict'; try { StaticMembersTests.Key.Escape = 1; return 'ok'; } catch (e) { return e.name; } })()");
+        REQUIRE(error == "TypeError");
+    }
+
+    SECTION("should call static methods") {
+        std::string name;
+        d.evalString(name, "StaticMembersTests.Key.nameOf(StaticMembersTests.Key.Escape)");
+        REQUIRE(name == "Escape");
+
+        int sum = 0;
+        d.evalString(sum, "StaticMembersTests.Math.add(2, 3)");
+        REQUIRE(sum == 5);
+    }
+
+    SECTION("should keep constructor working") {
+        bool created = false;
+        d.evalString(created, "new StaticMembersTests.Key() !== undefined");
+        REQUIRE(created);
+    }
+
+    SECTION("should register classes without constructor") {
+        int answer = 0;
+        d.evalString(answer, "StaticMembersTests.Math.Answer");
+        REQUIRE(answer == 42);
+        REQUIRE(duk_get_top(d) == 0);
+    }
+}
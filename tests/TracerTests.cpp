@@ -0,0 +1,94 @@
+#include <catch/catch.hpp>
+
+#include <duktape-cpp/DuktapeCpp.h>
+
+namespace TracerTests {
+
+class Sprite {
+public:
+    static std::shared_ptr<Sprite> create() { return std::make_shared<Sprite>(); }
+
+    void draw() {}
+
+    void move(int) {}
+
+    static int count() { return 1; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.construct(&Sprite::create);
+        i.method("draw", &Sprite::draw);
+        i.method("move", &Sprite::move);
+        i.staticMethod("count", &Sprite::count);
+    }
+};
+
+}
+
+DUK_CPP_DEF_CLASS_NAME(TracerTests::Sprite);
+
+TEST_CASE("Tracer", "[duktape]") {
+    using namespace TracerTests;
+
+    duk::Context d;
+    d.registerClass<Sprite>();
+
+    duk::Tracer::Clear();
+    duk::Tracer::Start();
+
+    d.evalStringNoRes("(function () { var s = new TracerTests.Sprite(); s.draw(); TracerTests.Sprite.count(); })()");
+    duk_gc(d, 0);
+    duk_gc(d, 0);
+
+    duk::Tracer::Stop();
+
+    std::string json = duk::Tracer::ChromeTraceJson();
+
+    REQUIRE(json.find("{\"traceEvents\":[") == 0);
+    REQUIRE(json.substr(json.size() - 2) == "]}");
+
+    if (!duk::Tracer::IsEnabled()) {
+        SECTION("should not record events") {
+            REQUIRE(json == "{\"traceEvents\":[]}");
+        }
+        return;
+    }
+
+    SECTION("should record complete events") {
+        REQUIRE(json.find("{\"name\":\"evalString\",\"cat\":\"eval\",\"ph\":\"X\"") != std::string::npos);
+        REQUIRE(json.find("{\"name\":\"TracerTests::Sprite\",\"cat\":\"constructor\",\"ph\":\"X\"") != std::string::npos);
+        REQUIRE(json.find("{\"name\":\"TracerTests::Sprite.draw\",\"cat\":\"method\",\"ph\":\"X\"") != std::string::npos);
+        REQUIRE(json.find("{\"name\":\"TracerTests::Sprite.count\",\"cat\":\"method\",\"ph\":\"X\"") != std::string::npos);
+        REQUIRE(json.find("{\"name\":\"TracerTests::Sprite\",\"cat\":\"finalizer\",\"ph\":\"X\"") != std::string::npos);
+        REQUIRE(json.find("\"dur\":") != std::string::npos);
+    }
+
+    SECTION("should record calls aborted by errors") {
+        duk::Tracer::Clear();
+        duk::Tracer::Start();
+
+        std::string res;
+        d.evalString(res,
+            "var res = [];\n"
+            "var s = new TracerTests.Sprite();\n"
+            "try { s.move('x'); } catch (e) { res.push(e.name); }\n"
+            "s.draw();\n"
+            "res.join(',')"
+        );
+
+        duk::Tracer::Stop();
+        json = duk::Tracer::ChromeTraceJson();
+
+        REQUIRE(res == "TypeError");
+        REQUIRE(json.find("{\"name\":\"TracerTests::Sprite.move\",\"cat\":\"method\",\"ph\":\"X\"") != std::string::npos);
+        REQUIRE(json.find("{\"name\":\"TracerTests::Sprite.draw\",\"cat\":\"method\",\"ph\":\"X\"") != std::string::npos);
+        REQUIRE(json.find("\"ph\":\"B\"") == std::string::npos);
+        REQUIRE(json.find("\"ph\":\"E\"") == std::string::npos);
+    }
+
+    SECTION("should not record events when stopped") {
+        duk::Tracer::Clear();
+        d.evalStringNoRes("1 + 1");
+        REQUIRE(duk::Tracer::ChromeTraceJson() == "{\"traceEvents\":[]}");
+    }
+}
@@ -0,0 +1,100 @@
+#include <catch/catch.hpp>
+
+#include <duktape-cpp/DuktapeCpp.h>
+
+namespace TrustedBindingsTests {
+
+class Particle {
+public:
+    virtual ~Particle() {}
+
+    double x() const { return _x; }
+    void move(double dx, int times, bool back) { _x += back ? -dx * times : dx * times; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.method("move", &Particle::move);
+        i.property("x", &Particle::x);
+    }
+
+protected:
+    double _x {0};
+};
+
+class Body: public Particle {
+public:
+    static std::shared_ptr<Body> create(double x) {
+        auto b = std::make_shared<Body>();
+        b->_x = x;
+        return b;
+    }
+
+    void follow(Particle &p) { _x = p.x(); }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.construct(&Body::create);
+        i.method("follow", &Body::follow);
+    }
+};
+
+}
+
+DUK_CPP_DEF_CLASS_NAME(TrustedBindingsTests::Particle);
+DUK_CPP_DEF_CLASS_NAME(TrustedBindingsTests::Body);
+DUK_CPP_DEF_BASE_CLASS(TrustedBindingsTests::Body, TrustedBindingsTests::Particle);
+DUK_CPP_DEF_TRUSTED(TrustedBindingsTests::Particle);
+DUK_CPP_DEF_TRUSTED(TrustedBindingsTests::Body);
+
+TEST_CASE("Trusted bindings", "[duktape]") {
+    using namespace TrustedBindingsTests;
+
+    duk::Context d;
+    d.registerClass<Body>();
+
+    SECTION("should skip checks only in release builds") {
+#if defined(NDEBUG)
+        REQUIRE(duk::details::UncheckedCalls<Body>::value);
+#else
+        REQUIRE_FALSE(duk::details::UncheckedCalls<Body>::value);
+#endif
+        REQUIRE_FALSE(duk::details::UncheckedCalls<int>::value);
+    }
+
+    SECTION("should call methods with valid arguments") {
+        double x = 0;
+        d.evalString(x,
+            "var a = new TrustedBindingsTests.Body(1);\n"
+            "var b = new TrustedBindingsTests.Body(10);\n"
+            "a.move(0.5, 4, false);\n"
+            "b.move(1, 2, true);\n"
+            "a.x + b.x"
+        );
+        REQUIRE(x == 11);
+    }
+
+    SECTION("should convert object arguments to base class") {
+        double x = 0;
+        d.evalString(x,
+            "var a = new TrustedBindingsTests.Body(1);\n"
+            "var b = new TrustedBindingsTests.Body(7);\n"
+            "a.follow(b);\n"
+            "a.x"
+        );
+        REQUIRE(x == 7);
+    }
+
+#if !defined(NDEBUG)
+    SECTION("should keep checks in debug builds") {
+        std::string res;
+        d.evalString(res, "try { new TrustedBindingsTests.Body(1).move('a', 1, true); 'ok' } catch (e) { e.name }");
+        REQUIRE(res == "TypeError");
+
+        d.evalString(res, "try { new TrustedBindingsTests.Body(1).follow({}); 'ok' } catch (e) { e.name }");
+        REQUIRE(res == "TypeError");
+
+        d.evalString(res, "try { TrustedBindingsTests.Body(1); 'ok' } catch (e) { 'error' }");
+        REQUIRE(res == "error");
+    }
+#endif
+}
@@ -0,0 +1,176 @@
+#include <catch/catch.hpp>
+
+#include <duktape-cpp/DuktapeCpp.h>
+
+namespace TypeRegistryTests {
+
+class Vehicle {
+public:
+    virtual ~Vehicle() {}
+
+    int wheels() const { return _wheels; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.property("wheels", &Vehicle::wheels);
+    }
+
+protected:
+    int _wheels {0};
+};
+
+class Car: public Vehicle {
+public:
+    static const int MaxSpeed = 200;
+
+    static std::shared_ptr<Car> create() { return std::make_shared<Car>(); }
+    static std::shared_ptr<Car> createWithWheels(int wheels) {
+        auto car = std::make_shared<Car>();
+        car->_wheels = wheels;
+        return car;
+    }
+    static std::string describe() { return "car"; }
+
+    Car() { _wheels = 4; }
+
+    int speed() const { return _speed; }
+    void setSpeed(int speed) { _speed = speed; }
+    int add(int a) const { return _speed + a; }
+    int add(int a, int b) const { return _speed + a + b; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.construct(&Car::create, &Car::createWithWheels);
+        i.constant("MaxSpeed", MaxSpeed);
+        i.staticMethod("describe", &Car::describe);
+        i.property("speed", &Car::speed, &Car::setSpeed);
+        i.method("add",
+                 static_cast<int (Car::*)(int) const>(&Car::add),
+                 static_cast<int (Car::*)(int, int) const>(&Car::add));
+    }
+
+private:
+    int _speed {0};
+};
+
+class Bike {
+public:
+    static std::shared_ptr<Bike> create(int gears) {
+        auto bike = std::make_shared<Bike>();
+        bike->_gears = gears;
+        return bike;
+    }
+
+    int gears() const { return _gears; }
+    std::string ring(int times) const { return std::string(std::size_t(times), '!'); }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.construct(&Bike::create);
+        i.method("gears", &Bike::gears);
+        i.method("ring", &Bike::ring);
+    }
+
+private:
+    int _gears {1};
+};
+
+class Unregistered {
+public:
+    template <class Inspector>
+    static void inspect(Inspector &i) {}
+};
+
+}
+
+DUK_CPP_DEF_CLASS_NAME(TypeRegistryTests::Vehicle);
+DUK_CPP_DEF_CLASS_NAME(TypeRegistryTests::Car);
+DUK_CPP_DEF_CLASS_NAME(TypeRegistryTests::Bike);
+DUK_CPP_DEF_CLASS_NAME(TypeRegistryTests::Unregistered);
+DUK_CPP_DEF_BASE_CLASS(TypeRegistryTests::Car, TypeRegistryTests::Vehicle);
+
+DUK_CPP_REGISTER_CLASS(TypeRegistryTests::Vehicle);
+DUK_CPP_REGISTER_CLASS(TypeRegistryTests::Car);
+DUK_CPP_REGISTER_CLASS(TypeRegistryTests::Bike);
+
+TEST_CASE("Type registry", "[duktape]") {
+    using namespace TypeRegistryTests;
+
+    duk::ContextOptions options;
+    options.registeredTypes = true;
+
+    SECTION("should register classes statically") {
+        REQUIRE(duk::TypeRegistry::IsRegistered<Car>());
+        REQUIRE_FALSE(duk::TypeRegistry::IsRegistered<Unregistered>());
+
+        // repeated registration has no effect
+        duk::TypeRegistry::Register<Car>();
+    }
+
+    SECTION("should define registered classes in new contexts") {
+        duk::Context d(options);
+
+        std::string res;
+        d.evalString(res,
+            "var car = new TypeRegistryTests.Car();\n"
+            "car.speed = 10;\n"
+            "[car.wheels, car.speed, car.add(1), car.add(1, 2), new TypeRegistryTests.Car(3).wheels,\n"
+            " TypeRegistryTests.Car.MaxSpeed, TypeRegistryTests.Car.describe(),\n"
+            " car instanceof TypeRegistryTests.Car].join(',')"
+        );
+        REQUIRE(res == "4,10,11,13,3,200,car,true");
+    }
+
+    SECTION("should share replayed functions between contexts") {
+        duk::Context a(options);
+        duk::Context b(options);
+
+        std::string res;
+        a.evalStringNoRes("var bike = new TypeRegistryTests.Bike(3);");
+        b.evalString(res, "var bike = new TypeRegistryTests.Bike(7); bike.gears() + bike.ring(2)");
+        REQUIRE(res == "7!!");
+
+        a.collectGarbage();
+        a.evalString(res, "bike.gears() + bike.ring(1)");
+        REQUIRE(res == "3!");
+
+        a.evalString(res, "try { TypeRegistryTests.Bike(1); 'ok' } catch (e) { 'error' }");
+        REQUIRE(res == "error");
+    }
+
+    SECTION("should not define registered classes by default") {
+        duk::Context d;
+
+        std::string res;
+        d.evalString(res, "typeof TypeRegistryTests");
+        REQUIRE(res == "undefined");
+
+        // registerClass uses the plan
+        d.registerClass<Car>();
+        int speed = -1;
+        d.evalString(speed, "var car = new TypeRegistryTests.Car(); car.speed = 7; car.add(0)");
+        REQUIRE(speed == 7);
+    }
+
+    SECTION("should register classes lazily") {
+        options.classRegistration = duk::ClassRegistration::Lazy;
+        duk::Context d(options);
+
+        bool lazy = false;
+        d.evalString(lazy, "typeof Object.getOwnPropertyDescriptor(TypeRegistryTests, 'Car').get === 'function'");
+        REQUIRE(lazy);
+
+        int wheels = 0;
+        d.evalString(wheels, "new TypeRegistryTests.Car().wheels");
+        REQUIRE(wheels == 4);
+    }
+
+    SECTION("should wrap pushed objects with registered prototypes") {
+        duk::Context d(options);
+        d.addGlobal("car", Car::create());
+
+        bool res = false;
+        d.evalString(res, "Object.getPrototypeOf(car) === TypeRegistryTests.Car.prototype && car.wheels === 4");
+        REQUIRE(res);
+    }
+}
@@ -0,0 +1,130 @@
+#include <catch/catch.hpp>
+
+#include <duktape-cpp/DuktapeCpp.h>
+
+namespace ValueObjectTests {
+
+class Color {
+public:
+    static int alive;
+
+    Color(int r, std::string name) : _r(r), _name(std::move(name)) { alive += 1; }
+    Color(Color const &that) : _r(that._r), _name(that._name) { alive += 1; }
+    Color(Color &&that) : _r(that._r), _name(std::move(that._name)) { alive += 1; }
+    ~Color() { alive -= 1; }
+
+    int red() const { return _r; }
+    std::string name() const { return _name; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.method("red", &Color::red);
+        i.property("name", &Color::name);
+    }
+
+private:
+    int _r;
+    std::string _name;
+};
+
+int Color::alive = 0;
+
+struct Point {
+    int x;
+    int y;
+
+    int sum() const { return x + y; }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.method("sum", &Point::sum);
+    }
+};
+
+class Palette {
+public:
+    Color color(int r) const { return Color(r, "color" + std::to_string(r)); }
+    Point point(int x, int y) const { return Point {x, y}; }
+
+    std::vector<Color> colors(int count) const {
+        std::vector<Color> res;
+        for (int i = 0; i < count; ++i) {
+            res.push_back(color(i));
+        }
+        return res;
+    }
+
+    template <class Inspector>
+    static void inspect(Inspector &i) {
+        i.method("color", &Palette::color);
+        i.method("point", &Palette::point);
+        i.method("colors", &Palette::colors);
+    }
+};
+
+}
+
+DUK_CPP_DEF_CLASS_NAME(ValueObjectTests::Color);
+DUK_CPP_DEF_CLASS_NAME(ValueObjectTests::Point);
+DUK_CPP_DEF_CLASS_NAME(ValueObjectTests::Palette);
+
+TEST_CASE("Objects returned by value", "[duktape]") {
+    using namespace ValueObjectTests;
+
+    int aliveBefore = Color::alive;
+
+    {
+        duk::Context d;
+        d.addGlobal("palette", std::make_shared<Palette>());
+
+        SECTION("should keep returned object alive") {
+            std::string res;
+            d.evalString(res, "var c = palette.color(42); palette.color(1); c.name + ':' + c.red()");
+            REQUIRE(res == "color42:42");
+        }
+
+        SECTION("should store trivially destructible objects") {
+            int res = 0;
+            d.evalString(res, "var p = palette.point(3, 4); palette.point(10, 10); p.sum()");
+            REQUIRE(res == 7);
+        }
+
+        SECTION("should share prototype between returned objects") {
+            bool same = false;
+            d.evalString(same, "palette.color(1).red === palette.color(2).red");
+            REQUIRE(same);
+        }
+
+        SECTION("should copy elements of returned vector") {
+            d.evalStringNoRes("var colors = palette.colors(3);");
+            REQUIRE(Color::alive == aliveBefore + 3);
+
+            d.collectGarbage();
+            Palette().colors(5);
+
+            std::string res;
+            d.evalString(res, "colors.map(function (c) { return c.name + ':' + c.red(); }).join(',')");
+            REQUIRE(res == "color0:0,color1:1,color2:2");
+        }
+
+        SECTION("should copy objects added as globals") {
+            d.addGlobal("black", Color(0, "black"));
+            d.collectGarbage();
+
+            std::string res;
+            d.evalString(res, "black.name");
+            REQUIRE(res == "black");
+        }
+
+        SECTION("should destroy objects when they are collected") {
+            d.evalStringNoRes("var colors = []; for (var i = 0; i < 10; i++) { colors.push(palette.color(i)); }");
+            REQUIRE(Color::alive == aliveBefore + 10);
+
+            d.evalStringNoRes("colors = null");
+            d.collectGarbage();
+            REQUIRE(Color::alive == aliveBefore);
+        }
+    }
+
+    REQUIRE(Color::alive == aliveBefore);
+}